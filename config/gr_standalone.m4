@@ -114,6 +114,6 @@ AC_DEFUN([GR_STANDALONE],
   AC_CHECK_PROG([XMLTO],[xmlto],[yes],[])
   AM_CONDITIONAL([HAS_XMLTO], [test x$XMLTO = xyes])
 
-  PKG_CHECK_MODULES(GNURADIO_CORE, gnuradio-core >= 3)
+  PKG_CHECK_MODULES(GNURADIO_CORE, gnuradio-core >= 3.5)
   LIBS="$LIBS $GNURADIO_CORE_LIBS"
 ])
@@ -26,16 +26,31 @@
 %{
 #include "gnuradio_swig_bug_workaround.h"	// mandatory bug fix
 #include "air_ms_pulse_detect.h"
+#include "air_ms_mag_pulse_detect.h"
+#include "air_ms_u8_pulse_detect.h"
+#include "air_ms_mag_pulse_detect_s.h"
+#include "air_ms_u8_pulse_detect_s.h"
 #include "air_ms_preamble.h"
 #include "air_ms_framer.h"
 #include "air_ms_ppm_decode.h"
+#include "air_ms_demod.h"
+#include "air_ms_demod_s.h"
+#include "air_ms_demod_lowrate.h"
 #include "air_ms_parity.h"
 #include "air_ms_ec_brute.h"
+#include "air_ms_ec_pool.h"
 #include "air_ms_fmt_log.h"
+#include "air_ms_fmt_binlog.h"
+#include "air_ms_log_sink.h"
 #include "air_ms_cvt_float.h"
+#include "air_ms_cvt_frame_v1.h"
+#include "air_ms_types.h"
 #include <stdexcept>
 %}
 
+// Item size of the frame streams
+%constant int sizeof_ms_frame_raw = sizeof(ms_frame_raw);
+
 // ----------------------------------------------------------------
 
 GR_SWIG_BLOCK_MAGIC(air,ms_pulse_detect);
@@ -52,6 +67,62 @@ public:
 
 // ----------------------------------------------------------------
 
+GR_SWIG_BLOCK_MAGIC(air,ms_mag_pulse_detect);
+
+air_ms_mag_pulse_detect_sptr air_make_ms_mag_pulse_detect(float alpha, float beta, int width);
+
+class air_ms_mag_pulse_detect : public gr_sync_block
+{
+private:
+    air_ms_mag_pulse_detect(float alpha, float beta, int width);
+
+public:
+};
+
+// ----------------------------------------------------------------
+
+GR_SWIG_BLOCK_MAGIC(air,ms_u8_pulse_detect);
+
+air_ms_u8_pulse_detect_sptr air_make_ms_u8_pulse_detect(float alpha, float beta, int width);
+
+class air_ms_u8_pulse_detect : public gr_sync_block
+{
+private:
+    air_ms_u8_pulse_detect(float alpha, float beta, int width);
+
+public:
+};
+
+// ----------------------------------------------------------------
+
+GR_SWIG_BLOCK_MAGIC(air,ms_mag_pulse_detect_s);
+
+air_ms_mag_pulse_detect_s_sptr air_make_ms_mag_pulse_detect_s(float alpha, float beta, int width, float scale);
+
+class air_ms_mag_pulse_detect_s : public gr_sync_block
+{
+private:
+    air_ms_mag_pulse_detect_s(float alpha, float beta, int width, float scale);
+
+public:
+};
+
+// ----------------------------------------------------------------
+
+GR_SWIG_BLOCK_MAGIC(air,ms_u8_pulse_detect_s);
+
+air_ms_u8_pulse_detect_s_sptr air_make_ms_u8_pulse_detect_s(float alpha, float beta, int width);
+
+class air_ms_u8_pulse_detect_s : public gr_sync_block
+{
+private:
+    air_ms_u8_pulse_detect_s(float alpha, float beta, int width);
+
+public:
+};
+
+// ----------------------------------------------------------------
+
 GR_SWIG_BLOCK_MAGIC(air,ms_preamble);
 
 air_ms_preamble_sptr air_make_ms_preamble(int channel_rate);
@@ -94,30 +165,113 @@ public:
 
 // ----------------------------------------------------------------
 
+GR_SWIG_BLOCK_MAGIC(air,ms_demod);
+
+air_ms_demod_sptr air_make_ms_demod(int channel_rate, bool toa = false);
+
+class air_ms_demod : public gr_block
+{
+private:
+    air_ms_demod(int channel_rate, bool toa);
+
+public:
+    unsigned long format_frames() const;
+    unsigned long pulse_frames() const;
+    unsigned long rejected_frames() const;
+    unsigned long toa_frames() const;
+};
+
+// ----------------------------------------------------------------
+
+GR_SWIG_BLOCK_MAGIC(air,ms_demod_s);
+
+air_ms_demod_s_sptr air_make_ms_demod_s(int channel_rate, float scale, bool toa = false);
+
+class air_ms_demod_s : public gr_block
+{
+private:
+    air_ms_demod_s(int channel_rate, float scale, bool toa);
+
+public:
+    unsigned long format_frames() const;
+    unsigned long pulse_frames() const;
+    unsigned long rejected_frames() const;
+    unsigned long toa_frames() const;
+};
+
+// ----------------------------------------------------------------
+
+GR_SWIG_BLOCK_MAGIC(air,ms_demod_lowrate);
+
+air_ms_demod_lowrate_sptr air_make_ms_demod_lowrate(int channel_rate, float threshold);
+
+class air_ms_demod_lowrate : public gr_block
+{
+private:
+    air_ms_demod_lowrate(int channel_rate, float threshold);
+
+public:
+    unsigned long candidates() const;
+    unsigned long format_frames() const;
+    unsigned long energy_frames() const;
+    unsigned long rejected_frames() const;
+};
+
+// ----------------------------------------------------------------
+
 GR_SWIG_BLOCK_MAGIC(air,ms_parity);
 
-air_ms_parity_sptr air_make_ms_parity();
+air_ms_parity_sptr air_make_ms_parity(bool address_cache = false);
 
 class air_ms_parity : public gr_sync_block
 {
 private:
-    air_ms_parity();
+    air_ms_parity(bool address_cache);
 
 public:
+    unsigned long cache_lookups() const;
+    unsigned long cache_hits() const;
+    unsigned long cache_probes() const;
+    unsigned long cache_inserts() const;
 };
 
 // ----------------------------------------------------------------
 
 GR_SWIG_BLOCK_MAGIC(air,ms_ec_brute);
 
-air_ms_ec_brute_sptr air_make_ms_ec_brute();
+air_ms_ec_brute_sptr air_make_ms_ec_brute(int max_lcbs = 12, double budget_us = 0.0, bool address_cache = false);
 
 class air_ms_ec_brute : public gr_sync_block
 {
 private:
-    air_ms_ec_brute();
+    air_ms_ec_brute(int max_lcbs, double budget_us, bool address_cache);
+
+public:
+    unsigned long table_corrections() const;
+    unsigned long search_corrections() const;
+    unsigned long address_corrections() const;
+    unsigned long memo_hits() const;
+    unsigned long memo_misses() const;
+    unsigned long deferred_frames() const;
+    unsigned long skipped_frames() const;
+};
+
+// ----------------------------------------------------------------
+GR_SWIG_BLOCK_MAGIC(air,ms_ec_pool);
+
+air_ms_ec_pool_sptr air_make_ms_ec_pool(int nthreads, int max_lcbs = 12, double max_latency_ms = 100.0, bool address_cache = false);
+
+class air_ms_ec_pool : public gr_block
+{
+private:
+    air_ms_ec_pool(int nthreads, int max_lcbs, double max_latency_ms, bool address_cache);
 
 public:
+    int queue_depth() const;
+    int max_queue_depth() const;
+    int reorder_depth() const;
+    unsigned long fast_frames() const;
+    unsigned long late_frames() const;
 };
 
 // ----------------------------------------------------------------
@@ -136,6 +290,40 @@ public:
 
 // ----------------------------------------------------------------
 
+GR_SWIG_BLOCK_MAGIC(air,ms_fmt_binlog);
+
+air_ms_fmt_binlog_sptr air_make_ms_fmt_binlog(int pass_all, const char *filename, int buffer_records = 16384) throw (std::runtime_error);
+
+class air_ms_fmt_binlog : public gr_sync_block
+{
+private:
+    air_ms_fmt_binlog(int pass_all, const char *filename, int buffer_records);
+
+public:
+};
+
+// ----------------------------------------------------------------
+
+GR_SWIG_BLOCK_MAGIC(air,ms_log_sink);
+
+air_ms_log_sink_sptr air_make_ms_log_sink(int pass_all, const char *filename, bool binary = false,
+                                          int sync = 1, double rotate_mb = 0.0, double rotate_seconds = 0.0,
+                                          double flush_seconds = 1.0, int buffer_kb = 1024) throw (std::runtime_error);
+
+class air_ms_log_sink : public gr_sync_block
+{
+private:
+    air_ms_log_sink(int pass_all, const char *filename, bool binary, int sync, double rotate_mb,
+                    double rotate_seconds, double flush_seconds, int buffer_kb);
+
+public:
+    unsigned long long bytes() const;
+    unsigned long files() const;
+    unsigned long waits() const;
+};
+
+// ----------------------------------------------------------------
+
 GR_SWIG_BLOCK_MAGIC(air,ms_cvt_float);
 
 air_ms_cvt_float_sptr air_make_ms_cvt_float();
@@ -147,3 +335,17 @@ private:
 
 public:
 };
+
+// ----------------------------------------------------------------
+
+GR_SWIG_BLOCK_MAGIC(air,ms_cvt_frame_v1);
+
+air_ms_cvt_frame_v1_sptr air_make_ms_cvt_frame_v1();
+
+class air_ms_cvt_frame_v1 : public gr_sync_block
+{
+private:
+    air_ms_cvt_frame_v1();
+
+public:
+};
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <air_ms_types.h>
+#include <air_ms_binlog.h>
+
+static void ms_put_le(unsigned char *p, uint64_t v, int n)
+{
+    for (int i = 0; i < n; i++)
+	p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t ms_get_le(const unsigned char *p, int n)
+{
+    uint64_t v = 0;
+    for (int i = n - 1; i >= 0; i--)
+	v = (v << 8) | p[i];
+    return v;
+}
+
+void ms_binlog_header(unsigned char *header)
+{
+    memset(header, 0, MS_BINLOG_HEADER_SIZE);
+    memcpy(header, MS_BINLOG_MAGIC, sizeof(MS_BINLOG_MAGIC));
+    ms_put_le(header + 8, MS_BINLOG_VERSION, 4);
+    ms_put_le(header + 12, MS_BINLOG_HEADER_SIZE, 4);
+    ms_put_le(header + 16, MS_BINLOG_RECORD_SIZE, 4);
+}
+
+unsigned int ms_binlog_check_header(const unsigned char *header, size_t size, unsigned int *header_size)
+{
+    if((size < MS_BINLOG_HEADER_SIZE) || memcmp(header, MS_BINLOG_MAGIC, sizeof(MS_BINLOG_MAGIC)))
+	return 0;
+    unsigned int version = ms_get_le(header + 8, 4);
+    unsigned int hsize = ms_get_le(header + 12, 4);
+    unsigned int record_size = ms_get_le(header + 16, 4);
+    // Later versions only add fields at the end of the header and records
+    if((version < 1) || (hsize < MS_BINLOG_HEADER_SIZE) || (record_size < MS_BINLOG_RECORD_SIZE))
+	return 0;
+    if(header_size)
+	*header_size = hsize;
+    return record_size;
+}
+
+void ms_binlog_encode(const ms_frame_raw &frame, unsigned char *record)
+{
+    uint32_t reference;
+    float f = frame.reference();
+    memcpy(&reference, &f, sizeof(reference));
+    int toa = -32768;
+    if(frame.toa_valid())
+	toa = (int)(frame.toa_offset() * 1024.0f);  // Exact, the frame keeps 1/1024 samples
+    memset(record, 0, MS_BINLOG_RECORD_SIZE);
+    ms_put_le(record, frame.timestamp(), 8);
+    ms_put_le(record + 8, frame.rx_time_ns(), 8);
+    ms_put_le(record + 16, reference, 4);
+    ms_put_le(record + 20, frame.address(), 4);
+    ms_put_le(record + 24, frame.ec_quality(), 2);
+    ms_put_le(record + 26, (uint16_t)toa, 2);
+    record[28] = frame.length();
+    memcpy(record + 32, frame.bits(), MS_FRAME_BYTES);
+    memcpy(record + 46, frame.lcbs(), MS_FRAME_BYTES);
+}
+
+void ms_binlog_decode(const unsigned char *record, ms_frame_raw &frame)
+{
+    uint32_t reference = ms_get_le(record + 16, 4);
+    float f;
+    memcpy(&f, &reference, sizeof(f));
+    int16_t toa = (int16_t)ms_get_le(record + 26, 2);
+    frame.reset_all();
+    frame.set_timestamp(ms_get_le(record, 8));
+    frame.set_rx_time_ns(ms_get_le(record + 8, 8));
+    frame.set_reference(f);
+    frame.set_address(ms_get_le(record + 20, 4));
+    frame.set_ec_quality(ms_get_le(record + 24, 2));
+    if(toa != -32768)
+	frame.set_toa(toa / 1024.0f);
+    if(record[28] == MS_LONG_FRAME_LENGTH)
+	frame.set_long_frame();
+    else if(record[28] == MS_SHORT_FRAME_LENGTH)
+	frame.set_short_frame();
+    const unsigned char *bits = record + 32;
+    const unsigned char *lcbs = record + 46;
+    for (int i = 0; i < MS_LONG_FRAME_LENGTH; i++)
+    {
+	int bit = (bits[i >> 3] >> (7 - (i & 7))) & 1;
+	if((lcbs[i >> 3] >> (7 - (i & 7))) & 1)
+		frame.set_bit_low_confidence(i, bit);
+	else
+		frame.set_bit_high_confidence(i, bit);
+    }
+}
+
+bool ms_binlog_write(int fd, const void *data, size_t n)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    while(n)
+    {
+	ssize_t r = write(fd, p, n);
+	if(r < 0)
+	{
+		if(errno == EINTR)
+			continue;
+		return false;
+	}
+	p += r;
+	n -= r;
+    }
+    return true;
+}
+
+int ms_binlog_open(const char *filename, std::string &error)
+{
+    unsigned char header[MS_BINLOG_HEADER_SIZE];
+    struct stat st;
+    int fd = ::open(filename, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if((fd < 0) || (fstat(fd, &st) < 0))
+    {
+	error = std::string(filename) + ": " + strerror(errno);
+	if(fd >= 0)
+		::close(fd);
+	return -1;
+    }
+    if(st.st_size == 0)
+    {
+	ms_binlog_header(header);
+	if(!ms_binlog_write(fd, header, sizeof(header)))
+	{
+		error = std::string(filename) + ": " + strerror(errno);
+		::close(fd);
+		return -1;
+	}
+	return fd;
+    }
+    unsigned int header_size = 0;
+    if((pread(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header)) ||
+       (ms_binlog_check_header(header, sizeof(header), &header_size) != MS_BINLOG_RECORD_SIZE) ||
+       (header_size != MS_BINLOG_HEADER_SIZE))
+    {
+	error = std::string(filename) + ": not a Mode S binary log of this version";
+	::close(fd);
+	return -1;
+    }
+    // A writer that stopped part way through a record leaves the tail
+    off_t tail = (st.st_size - MS_BINLOG_HEADER_SIZE) % MS_BINLOG_RECORD_SIZE;
+    if(tail && (ftruncate(fd, st.st_size - tail) < 0))
+    {
+	error = std::string(filename) + ": " + strerror(errno);
+	::close(fd);
+	return -1;
+    }
+    return fd;
+}
+
+ms_binlog_reader::ms_binlog_reader() :
+    d_map(0), d_map_size(0), d_records(0), d_record_size(MS_BINLOG_RECORD_SIZE), d_count(0)
+{
+}
+
+ms_binlog_reader::~ms_binlog_reader()
+{
+    close();
+}
+
+bool ms_binlog_reader::open(const char *filename)
+{
+    close();
+    int fd = ::open(filename, O_RDONLY);
+    if(fd < 0)
+    {
+	d_error = std::string(filename) + ": " + strerror(errno);
+	return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) < 0)
+    {
+	d_error = std::string(filename) + ": " + strerror(errno);
+	::close(fd);
+	return false;
+    }
+    d_map_size = st.st_size;
+    if(d_map_size >= MS_BINLOG_HEADER_SIZE)
+    {
+	d_map = mmap(0, d_map_size, PROT_READ, MAP_SHARED, fd, 0);
+	if(d_map == MAP_FAILED)
+	{
+		d_map = 0;
+		d_error = std::string(filename) + ": " + strerror(errno);
+		::close(fd);
+		return false;
+	}
+    }
+    ::close(fd);  // The mapping stays
+    const unsigned char *p = (const unsigned char *)d_map;
+    unsigned int header_size = 0;
+    d_record_size = d_map ? ms_binlog_check_header(p, d_map_size, &header_size) : 0;
+    if((d_record_size == 0) || (header_size > d_map_size))
+    {
+	d_error = std::string(filename) + ": not a Mode S binary log";
+	close();
+	return false;
+    }
+    madvise(d_map, d_map_size, MADV_SEQUENTIAL);
+    d_records = p + header_size;
+    d_count = (d_map_size - header_size) / d_record_size;
+    d_error.clear();
+    return true;
+}
+
+void ms_binlog_reader::close()
+{
+    if(d_map)
+	munmap(d_map, d_map_size);
+    d_map = 0;
+    d_map_size = 0;
+    d_records = 0;
+    d_count = 0;
+}
+
+void ms_binlog_reader::frame(size_t index, ms_frame_raw &frame) const
+{
+    ms_binlog_decode(record(index), frame);
+}
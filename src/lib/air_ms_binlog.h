@@ -0,0 +1,117 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_BINLOG_H
+#define INCLUDED_AIR_MS_BINLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class ms_frame_raw;
+
+/*
+ * Binary Mode S frame log, see ms_fmt_binlog
+ *
+ * A 32 byte header then 64 byte records, all little endian.  A program that
+ * reads the log checks the magic and version and steps by the record size in
+ * the header so fields added at the end of a record by later versions are
+ * skipped.  The records start after the header size in the header, which
+ * later versions may also add fields to the end of.  A record cut short at the end of the log is not a record.
+ *
+ * Header
+ *    0  8  magic "AIRMSBIN"
+ *    8  4  version
+ *   12  4  header size
+ *   16  4  record size
+ *   20 12  zero
+ *
+ * Record, version 1
+ *    0  8  timestamp, sample number of the data start
+ *    8  8  rx_time, nanoseconds since the epoch of the data start
+ *   16  4  reference level, IEEE 754 single
+ *   20  4  address
+ *   24  2  ec_quality
+ *   26  2  arrival of the data start less the timestamp in 1/1024 samples,
+ *          -32768 if not refined
+ *   28  1  length in bits, 56 or 112, zero if not framed
+ *   29  3  zero
+ *   32 14  bits, bit 0 of the frame in the msb of the first byte
+ *   46 14  low confidence bits, the same way
+ *   60  4  zero
+ */
+const char MS_BINLOG_MAGIC[8] = { 'A', 'I', 'R', 'M', 'S', 'B', 'I', 'N' };
+const unsigned int MS_BINLOG_VERSION = 1;
+const unsigned int MS_BINLOG_HEADER_SIZE = 32;
+const unsigned int MS_BINLOG_RECORD_SIZE = 64;
+
+// Header for a new log
+void ms_binlog_header(unsigned char *header);
+// Record size of a log with this header, zero if it is not a log this
+// version can read.  The size of the header is put in header_size if given.
+unsigned int ms_binlog_check_header(const unsigned char *header, size_t size, unsigned int *header_size = 0);
+// Record of a frame and the frame of a record
+void ms_binlog_encode(const ms_frame_raw &frame, unsigned char *record);
+void ms_binlog_decode(const unsigned char *record, ms_frame_raw &frame);
+// Open a log to append records to, writing the header if the file is new
+// and dropping a record cut short at its end.  -1 with error set if the
+// file can not be opened or is not a log this version writes, one with the
+// header and records of this version.
+int ms_binlog_open(const char *filename, std::string &error);
+// Write all n bytes to a log, going on after short writes.  False on an error
+// with errno set.
+bool ms_binlog_write(int fd, const void *data, size_t n);
+
+/*!
+ * \brief Read only view of a binary frame log
+ *
+ * The log is mapped into memory and the records are decoded as they are
+ * asked for.  Records appended after open are not seen.
+ */
+class ms_binlog_reader
+{
+public:
+    ms_binlog_reader();
+    ~ms_binlog_reader();
+
+    // False with error() set if the file is not a log this version can read
+    bool open(const char *filename);
+    void close();
+
+    size_t size() const { return d_count; }   // Number of whole records
+    const unsigned char *record(size_t index) const { return d_records + index * d_record_size; }
+    void frame(size_t index, ms_frame_raw &frame) const;
+    const std::string &error() const { return d_error; }
+
+private:
+    // Not copyable, the mapping is owned
+    ms_binlog_reader(const ms_binlog_reader &);
+    ms_binlog_reader &operator=(const ms_binlog_reader &);
+
+    void *d_map;                    // Mapping of the whole file, 0 if none
+    size_t d_map_size;
+    const unsigned char *d_records; // First record
+    size_t d_record_size;
+    size_t d_count;
+    std::string d_error;
+};
+
+#endif /* INCLUDED_AIR_MS_BINLOG_H */
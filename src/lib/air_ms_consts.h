@@ -25,6 +25,8 @@
 
 const int MS_SHORT_FRAME_LENGTH    =  56;  // Data length for short frame
 const int MS_LONG_FRAME_LENGTH     = 112;
+const int MS_FRAME_BYTES           = MS_LONG_FRAME_LENGTH / 8;  // Packed frame bytes
+const int MS_DF_LENGTH             =   5;  // Bits of the downlink format field
 
 const int MS_DATA_RATE             = 1000000;
 const int MS_PREAMBLE_PULSE_COUNT  =   4;
@@ -23,11 +23,15 @@
 Convert the data in pipeline info as floats so it can be displayed on the oscilloscope
 Also handle sample data so everything stays in sync.
 
+The reference level comes from the stream tags.  It is shown at a preamble start and
+held from the data start to the data end of a frame.
+
 */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
+#include <algorithm>
 #include <gr_io_signature.h>
 #include <air_ms_types.h>
 #include <air_ms_cvt_float.h>
@@ -42,6 +46,9 @@ air_ms_cvt_float::air_ms_cvt_float() :
                    gr_make_io_signature2 (2, 2, sizeof(float), sizeof(ms_plinfo)),
                    gr_make_io_signature (3, 3, sizeof(float)))
 {
+    d_reference = 0.0;
+    d_preamble_ref_key = pmt::pmt_string_to_symbol(MS_TAG_PREAMBLE_REF);
+    d_data_ref_key = pmt::pmt_string_to_symbol(MS_TAG_DATA_REF);
     set_output_multiple(1);
 }
 
@@ -59,11 +66,38 @@ int air_ms_cvt_float::work(int noutput_items,
 
     int size = noutput_items;
     int i;
+    uint64_t nread = nitems_read(1);
     for (i = 0; i < size; i++)
     {
 	data_out[i] = data_in[i]; // Direct Copy
-	ref_out[i] = attrib_in[i].reference();
+	ref_out[i] = d_reference;
         attrib_out[i] = (float)attrib_in[i].flags() *-20.;  // Make it visible by inverting it
+	if(attrib_in[i].data_end())
+		d_reference = 0.0;
+    }
+    // Fill in the tagged references
+    get_tags_in_range(d_tags, 1, nread, nread + size);
+    std::sort(d_tags.begin(), d_tags.end(), gr_tag_t::offset_compare);
+    for (unsigned int t = 0; t < d_tags.size(); t++)
+    {
+	int pos = d_tags[t].offset - nread;
+	if(pmt::pmt_eq(d_tags[t].key, d_preamble_ref_key))
+	{
+		ref_out[pos] = pmt::pmt_to_double(d_tags[t].value);
+	}
+	else if(pmt::pmt_eq(d_tags[t].key, d_data_ref_key))
+	{
+		// Hold the reference to the end of the data
+		for (d_reference = pmt::pmt_to_double(d_tags[t].value); pos < size; pos++)
+		{
+			ref_out[pos] = d_reference;
+			if(attrib_in[pos].data_end())
+			{
+				d_reference = 0.0;
+				break;
+			}
+		}
+	}
     }
     return i;
 }
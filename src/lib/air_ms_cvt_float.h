@@ -23,6 +23,7 @@
 #define INCLUDED_AIR_MS_CVT_FLOAT_H
 
 #include <gr_sync_block.h>
+#include <vector>
 
 class air_ms_cvt_float;
 typedef boost::shared_ptr<air_ms_cvt_float> air_ms_cvt_float_sptr;
@@ -39,6 +40,10 @@ private:
     friend air_ms_cvt_float_sptr air_make_ms_cvt_float();
     air_ms_cvt_float();
 
+    float d_reference;   // reference level held from data start to data end
+    pmt::pmt_t d_preamble_ref_key;  // Tag key for the reference at a preamble start
+    pmt::pmt_t d_data_ref_key;      // Tag key for the reference at a data start
+    std::vector<gr_tag_t> d_tags;   // References in the current work call
 
 public:
     int work (int noutput_items,
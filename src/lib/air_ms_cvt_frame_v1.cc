@@ -0,0 +1,78 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gr_io_signature.h>
+#include <air_ms_types.h>
+#include <air_ms_frame_v1.h>
+#include <air_ms_cvt_frame_v1.h>
+
+air_ms_cvt_frame_v1_sptr air_make_ms_cvt_frame_v1()
+{
+    return air_ms_cvt_frame_v1_sptr(new air_ms_cvt_frame_v1());
+}
+
+air_ms_cvt_frame_v1::air_ms_cvt_frame_v1() :
+    gr_sync_block ("ms_cvt_frame_v1",
+                   gr_make_io_signature (1, 1, sizeof(ms_frame_raw)),
+                   gr_make_io_signature (1, 1, sizeof(ms_frame_raw_v1)))
+{
+}
+
+int air_ms_cvt_frame_v1::work(int noutput_items,
+                          gr_vector_const_void_star &input_items,
+	                  gr_vector_void_star &output_items)
+
+{
+    const ms_frame_raw *data_in = (const ms_frame_raw *)input_items[0];
+    ms_frame_raw_v1 *data_out = (ms_frame_raw_v1 *)output_items[0];
+
+    int i, j;
+    for (i = 0; i < noutput_items; i++)
+    {
+	const ms_frame_raw &in = data_in[i];
+	ms_frame_raw_v1 &out = data_out[i];
+	out.reset_all();
+	out.set_timestamp((int)in.timestamp());  // v1 keeps the low 32 bits
+	out.set_reference(in.reference());
+	if(in.length() == MS_LONG_FRAME_LENGTH)
+		out.set_long_frame();
+	else if(in.length() == MS_SHORT_FRAME_LENGTH)
+		out.set_short_frame();
+	for (j = 0; j < MS_LONG_FRAME_LENGTH; j++)
+	{
+		if(in.bit_low_energy(j))
+			out.set_bit_low_energy(j, in.bit(j));
+		else if(in.bit_low_confidence(j))
+			out.set_bit_low_confidence(j, in.bit(j));
+		else
+			out.set_bit_high_confidence(j, in.bit(j));
+	}
+	out.count_lcbs();
+	out.set_ec_quality(in.ec_quality());
+	out.set_rx_time(in.rx_time());
+	out.set_address(in.address());
+    }
+    return noutput_items;
+}
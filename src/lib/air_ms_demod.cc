@@ -0,0 +1,103 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <gr_io_signature.h>
+#include <air_ms_types.h>
+#include <air_ms_demod.h>
+#include <airi_ms_demod.h>
+#include <airi_ms_clock.h>
+
+air_ms_demod_sptr air_make_ms_demod(int channel_rate, bool toa)
+{
+    return air_ms_demod_sptr(new air_ms_demod(channel_rate, toa));
+}
+
+air_ms_demod::air_ms_demod(int channel_rate, bool toa) :
+    gr_block ("ms_demod",
+                   gr_make_io_signature2 (2, 2, sizeof(float), sizeof(ms_plinfo)),
+                   gr_make_io_signature (1, 1, sizeof(ms_frame_raw)))
+{
+    d_channel_rate = channel_rate;
+    d_kernel = ms_make_demod_kernel(channel_rate, toa);
+    d_rx_time_key = pmt::pmt_string_to_symbol(MS_TAG_RX_TIME);
+
+    // Same channel occupancy assumption as ms_ppm_decode
+    set_relative_rate(1.0/((double)d_kernel->max_frame_width()*2.0+2.0));
+}
+
+air_ms_demod::~air_ms_demod()
+{
+    delete d_kernel;
+}
+
+unsigned long air_ms_demod::format_frames() const
+{
+    return d_kernel->format_frames();
+}
+
+unsigned long air_ms_demod::pulse_frames() const
+{
+    return d_kernel->pulse_frames();
+}
+
+unsigned long air_ms_demod::rejected_frames() const
+{
+    return d_kernel->rejected_frames();
+}
+
+unsigned long air_ms_demod::toa_frames() const
+{
+    return d_kernel->toa_frames();
+}
+
+void air_ms_demod::forecast (int noutput_items,
+	       gr_vector_int &ninput_items_required)
+{
+	int size;
+	size = noutput_items*d_kernel->max_frame_width()+d_kernel->lookahead();
+	ninput_items_required[1] = ninput_items_required[0] = size;
+}
+
+int air_ms_demod::general_work(int noutput_items,
+		                gr_vector_int &ninput_items,
+		                gr_vector_const_void_star &input_items,
+	                        gr_vector_void_star &output_items)
+
+{
+    const float *data_in = (const float *)input_items[0];
+    const ms_plinfo *attrib_in = (const ms_plinfo *)input_items[1];
+    ms_frame_raw *data_out = (ms_frame_raw *) output_items[0];  // sample data out
+
+    int ninput = std::min(ninput_items[0], ninput_items[1]);
+    uint64_t nread = nitems_read(0);
+    int consumed;
+    get_tags_in_range(d_time_tags, 0, nread, nread + ninput, d_rx_time_key);
+    std::sort(d_time_tags.begin(), d_time_tags.end(), gr_tag_t::offset_compare);
+    d_kernel->clock().add_tags(d_time_tags);
+    int out_count = d_kernel->demod(data_in, attrib_in, ninput, nread, data_out, noutput_items, consumed);
+    consume_each(consumed);
+    return out_count;
+}
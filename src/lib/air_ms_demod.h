@@ -0,0 +1,75 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_DEMOD_H
+#define INCLUDED_AIR_MS_DEMOD_H
+
+#include <gr_block.h>
+#include <vector>
+
+class air_ms_demod;
+class ms_demod_kernel;
+typedef boost::shared_ptr<air_ms_demod> air_ms_demod_sptr;
+
+air_ms_demod_sptr air_make_ms_demod(int channel_rate, bool toa = false);
+
+/*!
+ * \brief mode select demodulator
+ * \ingroup block
+ *
+ * Input is the samples and attributes from the pulse detector, output is the
+ * raw Mode S frames.  Does the work of ms_preamble, ms_framer and ms_ppm_decode
+ * in one pass over the samples and produces the same frames.
+ *
+ * With toa the arrival time of the frames that pass the parity check with a
+ * zero syndrome is refined to a fraction of a sample, see ms_frame_raw::toa().
+ */
+class air_ms_demod : public gr_block
+{
+private:
+    friend air_ms_demod_sptr air_make_ms_demod(int channel_rate, bool toa);
+    air_ms_demod(int channel_rate, bool toa);
+
+    int d_channel_rate;  // Sample rate of the streams
+    ms_demod_kernel *d_kernel;         // Preamble search, framing and slicing
+    pmt::pmt_t d_rx_time_key;          // Tag key for the time of a sample
+    std::vector<gr_tag_t> d_time_tags; // Sample times in the current work call
+
+public:
+    ~air_ms_demod();
+    void forecast (int noutput_items,
+		   gr_vector_int &ninput_items_required);
+
+    int general_work (int noutput_items,
+		      gr_vector_int &ninput_items,
+		      gr_vector_const_void_star &input_items,
+		      gr_vector_void_star &output_items);
+
+    // Frames with the length from the downlink format, from bits 57 through 62
+    // as a format bit was of low confidence, and not valid formats
+    unsigned long format_frames() const;
+    unsigned long pulse_frames() const;
+    unsigned long rejected_frames() const;
+    // Frames with a refined arrival time
+    unsigned long toa_frames() const;
+};
+
+#endif /* INCLUDED_AIR_MS_DEMOD_H */
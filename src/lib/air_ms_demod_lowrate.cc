@@ -0,0 +1,153 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <gr_io_signature.h>
+#include <air_ms_types.h>
+#include <air_ms_demod_lowrate.h>
+#include <airi_ms_lowrate.h>
+#include <airi_ms_clock.h>
+
+air_ms_demod_lowrate_sptr air_make_ms_demod_lowrate(int channel_rate, float threshold)
+{
+    return air_ms_demod_lowrate_sptr(new air_ms_demod_lowrate(channel_rate, threshold));
+}
+
+air_ms_demod_lowrate::air_ms_demod_lowrate(int channel_rate, float threshold) :
+    gr_block ("ms_demod_lowrate",
+                   gr_make_io_signature (1, 1, sizeof(float)),
+                   gr_make_io_signature (1, 1, sizeof(ms_frame_raw)))
+{
+    d_channel_rate = channel_rate;
+    d_kernel = new ms_lowrate_kernel(channel_rate, threshold);
+    d_clock = new ms_sample_clock(channel_rate);
+    d_rx_time_key = pmt::pmt_string_to_symbol(MS_TAG_RX_TIME);
+    // A frame and the retrigger checks on its last sample
+    d_lookahead = d_kernel->max_frame_width() + d_kernel->preamble_width();
+
+    // Same channel occupancy assumption as ms_ppm_decode
+    set_relative_rate(1.0/((double)d_kernel->max_frame_width()*2.0+2.0));
+}
+
+air_ms_demod_lowrate::~air_ms_demod_lowrate()
+{
+    delete d_kernel;
+    delete d_clock;
+}
+
+unsigned long air_ms_demod_lowrate::candidates() const
+{
+    return d_kernel->candidates();
+}
+
+unsigned long air_ms_demod_lowrate::format_frames() const
+{
+    return d_kernel->format_frames();
+}
+
+unsigned long air_ms_demod_lowrate::energy_frames() const
+{
+    return d_kernel->energy_frames();
+}
+
+unsigned long air_ms_demod_lowrate::rejected_frames() const
+{
+    return d_kernel->rejected_frames();
+}
+
+void air_ms_demod_lowrate::forecast (int noutput_items,
+	       gr_vector_int &ninput_items_required)
+{
+	ninput_items_required[0] = noutput_items*d_kernel->max_frame_width()+d_lookahead;
+}
+
+int air_ms_demod_lowrate::general_work(int noutput_items,
+		                gr_vector_int &ninput_items,
+		                gr_vector_const_void_star &input_items,
+	                        gr_vector_void_star &output_items)
+
+{
+    float *data_in = (float *)input_items[0];
+    ms_frame_raw *data_out = (ms_frame_raw *) output_items[0];  // sample data out
+
+    int size = ninput_items[0] - d_lookahead; // Only search up to a frame from the end
+    int ticks = d_kernel->ticks_per_sample();
+    int i, k, t;
+    int out_count = 0;
+    int length;
+    int frame_size;
+    int stronger;
+    float reference;
+    float later;
+    uint64_t nread = nitems_read(0);
+    if(size <= 0)
+    {
+	consume_each(0);
+	return 0;
+    }
+    get_tags_in_range(d_time_tags, 0, nread, nread + ninput_items[0], d_rx_time_key);
+    std::sort(d_time_tags.begin(), d_time_tags.end(), gr_tag_t::offset_compare);
+    d_clock->add_tags(d_time_tags);
+    for (i = 0; (i < size) && (out_count < noutput_items); )
+    {
+	t = d_kernel->find(data_in, i, size, reference);
+	i = t / ticks;
+	if(i >= size)
+		break;
+	length = d_kernel->frame_length(data_in, t, reference);
+	if(length == 0)
+	{
+		i++;  // Not a valid downlink format so look again from the next sample
+		continue;
+	}
+	frame_size = d_kernel->frame_width(t, length);
+        // "Retrigger"  A preamble more than 3 dB stronger in the frame takes over from it
+	stronger = -1;
+	for (k = d_kernel->find(data_in, i + 1, i + frame_size, later) / ticks;
+	     k < i + frame_size;
+	     k = d_kernel->find(data_in, k + 1, i + frame_size, later) / ticks)
+	{
+		if(later > reference * 1.41253)  // + 3 dB
+		{
+			stronger = k;
+			break;
+		}
+	}
+	if(stronger >= 0)
+	{
+		i = stronger;
+		continue;
+	}
+	ms_frame_raw &frame = data_out[out_count++];
+	frame.reset_all();
+	frame.set_timestamp(nread + i + d_kernel->data_start(t));
+	frame.set_rx_time_ns(d_clock->time_ns(nread + i + d_kernel->data_start(t)));
+	frame.set_reference(reference);
+	d_kernel->slice(data_in, t, reference, length, frame);
+	i += frame_size;
+    }
+    consume_each(i);
+    return out_count;
+}
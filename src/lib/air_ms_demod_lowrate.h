@@ -0,0 +1,77 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_DEMOD_LOWRATE_H
+#define INCLUDED_AIR_MS_DEMOD_LOWRATE_H
+
+#include <gr_block.h>
+#include <vector>
+
+class air_ms_demod_lowrate;
+class ms_lowrate_kernel;
+class ms_sample_clock;
+typedef boost::shared_ptr<air_ms_demod_lowrate> air_ms_demod_lowrate_sptr;
+
+air_ms_demod_lowrate_sptr air_make_ms_demod_lowrate(int channel_rate, float threshold);
+
+/*!
+ * \brief mode select demodulator for 2 to 2.4 Msps
+ * \ingroup block
+ *
+ * Input is the magnitude of the channel, output is the raw Mode S frames.
+ * Finds the preambles, the frame length and the bits from the chip levels
+ * without resampling to 8 Msps, see ms_lowrate_kernel.  Threshold is the
+ * smallest preamble pulse level.  Like ms_demod a frame with a preamble 3 dB
+ * stronger in it is dropped for the stronger one.
+ */
+class air_ms_demod_lowrate : public gr_block
+{
+private:
+    friend air_ms_demod_lowrate_sptr air_make_ms_demod_lowrate(int channel_rate, float threshold);
+    air_ms_demod_lowrate(int channel_rate, float threshold);
+
+    int d_channel_rate;  // Sample rate of the stream
+    int d_lookahead;     // Samples needed after the last preamble start searched
+    ms_lowrate_kernel *d_kernel;       // Preamble search and bit slicer
+    ms_sample_clock *d_clock;          // Time of the frames
+    pmt::pmt_t d_rx_time_key;          // Tag key for the time of a sample
+    std::vector<gr_tag_t> d_time_tags; // Sample times in the current work call
+
+public:
+    ~air_ms_demod_lowrate();
+    void forecast (int noutput_items,
+		   gr_vector_int &ninput_items_required);
+
+    int general_work (int noutput_items,
+		      gr_vector_int &ninput_items,
+		      gr_vector_const_void_star &input_items,
+		      gr_vector_void_star &output_items);
+
+    // Samples given the full preamble check, frames with the length from the
+    // downlink format, from bits 57 through 62 as a format bit was of low
+    // confidence, and not valid formats
+    unsigned long candidates() const;
+    unsigned long format_frames() const;
+    unsigned long energy_frames() const;
+    unsigned long rejected_frames() const;
+};
+
+#endif /* INCLUDED_AIR_MS_DEMOD_LOWRATE_H */
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_DEMOD_S_H
+#define INCLUDED_AIR_MS_DEMOD_S_H
+
+#include <gr_block.h>
+#include <vector>
+
+class air_ms_demod_s;
+class ms_demod_kernel;
+typedef boost::shared_ptr<air_ms_demod_s> air_ms_demod_s_sptr;
+
+air_ms_demod_s_sptr air_make_ms_demod_s(int channel_rate, float scale, bool toa = false);
+
+/*!
+ * \brief mode select demodulator of fixed point samples
+ * \ingroup block
+ *
+ * Same as ms_demod but the samples are unsigned short magnitudes from
+ * ms_mag_pulse_detect_s or ms_u8_pulse_detect_s, and the level tests are
+ * integer multiplies.  scale is the fixed point units per unit of the
+ * magnitude the detector was given, and the reference level of the frames is
+ * in the units of the magnitude.
+ */
+class air_ms_demod_s : public gr_block
+{
+private:
+    friend air_ms_demod_s_sptr air_make_ms_demod_s(int channel_rate, float scale, bool toa);
+    air_ms_demod_s(int channel_rate, float scale, bool toa);
+
+    int d_channel_rate;  // Sample rate of the streams
+    ms_demod_kernel *d_kernel;         // Preamble search, framing and slicing
+    pmt::pmt_t d_rx_time_key;          // Tag key for the time of a sample
+    std::vector<gr_tag_t> d_time_tags; // Sample times in the current work call
+
+public:
+    ~air_ms_demod_s();
+    void forecast (int noutput_items,
+		   gr_vector_int &ninput_items_required);
+
+    int general_work (int noutput_items,
+		      gr_vector_int &ninput_items,
+		      gr_vector_const_void_star &input_items,
+		      gr_vector_void_star &output_items);
+
+    // Frames with the length from the downlink format, from bits 57 through 62
+    // as a format bit was of low confidence, and not valid formats
+    unsigned long format_frames() const;
+    unsigned long pulse_frames() const;
+    unsigned long rejected_frames() const;
+    // Frames with a refined arrival time
+    unsigned long toa_frames() const;
+};
+
+#endif /* INCLUDED_AIR_MS_DEMOD_S_H */
@@ -24,25 +24,72 @@
 #endif
 
 #include <air_ms_ec_brute.h>
-#include <airi_ms_parity.h>
+#include <airi_ms_ec.h>
+#include <airi_ms_address.h>
 #include <gr_io_signature.h>
 #include <air_ms_types.h>
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 // The recommendation is to do a convervative error correction of 12 bits and a brute force of 5 bits.
-// The modern processor should be able to do 12 bits brute force :)
+// The meet in the middle search takes up to 24 bits.
 const int MAX_EC_CORRECTION = 12;
 
 
-air_ms_ec_brute_sptr air_make_ms_ec_brute()
+air_ms_ec_brute_sptr air_make_ms_ec_brute(int max_lcbs, double budget_us, bool address_cache)
 {
-    return air_ms_ec_brute_sptr(new air_ms_ec_brute());
+    return air_ms_ec_brute_sptr(new air_ms_ec_brute(max_lcbs, budget_us, address_cache));
 }
 
-air_ms_ec_brute::air_ms_ec_brute() :
+air_ms_ec_brute::air_ms_ec_brute(int max_lcbs, double budget_us, bool address_cache) :
     gr_sync_block("ms_ec_brute",
 	gr_make_io_signature(1, 1, sizeof(ms_frame_raw)),
-	gr_make_io_signature(1, 1, sizeof(ms_frame_raw)))
+	gr_make_io_signature(1, 1, sizeof(ms_frame_raw))),
+    d_budget_us(budget_us),
+    d_deferred(0)
 {
+    d_ec = new ms_ec_corrector((max_lcbs < 0) ? MAX_EC_CORRECTION : max_lcbs,
+	address_cache ? &ms_address_cache::shared() : 0);
+}
+
+air_ms_ec_brute::~air_ms_ec_brute()
+{
+    delete d_ec;
+}
+
+unsigned long air_ms_ec_brute::table_corrections() const
+{
+    return d_ec->table_corrections();
+}
+
+unsigned long air_ms_ec_brute::search_corrections() const
+{
+    return d_ec->search_corrections();
+}
+
+unsigned long air_ms_ec_brute::address_corrections() const
+{
+    return d_ec->address_corrections();
+}
+
+unsigned long air_ms_ec_brute::memo_hits() const
+{
+    return d_ec->memo_hits();
+}
+
+unsigned long air_ms_ec_brute::memo_misses() const
+{
+    return d_ec->memo_misses();
+}
+
+unsigned long air_ms_ec_brute::deferred_frames() const
+{
+    return d_deferred;
+}
+
+unsigned long air_ms_ec_brute::skipped_frames() const
+{
+    return d_ec->skipped_frames();
 }
 
 int air_ms_ec_brute::work(int noutput_items,
@@ -52,85 +99,36 @@ int air_ms_ec_brute::work(int noutput_items,
     ms_frame_raw *data_in = (ms_frame_raw *)input_items[0];
     ms_frame_raw *data_out = (ms_frame_raw *)output_items[0];
 
-    unsigned int error_syndrome = 0;
-    unsigned int crc;
-    int lcb_positions[MAX_EC_CORRECTION + 1];
-    int i, j, index;
-    int search_code;
-    int offset;
-    int found;
-    int correction = 0;
+    int i, k;
+    if(d_budget_us <= 0.0)
+    {
+	for (i = 0; i < noutput_items; i++) {
+		data_out[i] = data_in[i];
+		d_ec->correct(data_out[i]);
+	}
+	return i;
+    }
+    // With a budget the frames that need a search are done cheapest first
+    // The search cost grows with the low confidence bits then the frame length
+    d_order.clear();
     for (i = 0; i < noutput_items; i++) {
 	data_out[i] = data_in[i];
-	if((data_out[i].lcb_count() == 0) || (data_out[i].ec_quality() & (ms_frame_raw::crc_ok | ms_frame_raw::eq_ec_corrected)))
-		continue;  // Nothing to do so continue on
-        // The assumption is Mode A/C "Fruit" flipped some bits that were set as low confidence upstream.
-        // This will only work for ADS-B and ACAS/TCAS Frames as the address overlayed on the parity is zero.
-	if(data_out[i].lcb_count() <= MAX_EC_CORRECTION)
-	{
-		// Get the error
-		error_syndrome = ms_check_parity(data_out[i]);
-		index = 0;
-		found = 0;
-                // Offset into the parity table for short frames  The offsets are 0 for long frames and 56 for short frames
-		offset = MS_LONG_FRAME_LENGTH - data_out[i].length();
- 		// Assume all bits need to be flipped so start at the high end
-		search_code = (1 << data_out[i].lcb_count()) - 1;
-		// Get the low confidence bits
-		lcb_positions[index++] = data_out[i].first_lcb();
-		for (j= data_out[i].first_lcb() + 1; j <= data_out[i].last_lcb();j++)
-		{
-			if(data_out[i].flags(j))
-			{
-				lcb_positions[index++] =j;
-			}
-		}
-		// Search down
-		// Zero code means no correction which at this point is not possible
-		while(search_code > 0)
-		{
-			crc = 0;
-			// Calculate the syndrome for the search code
-			for(j = 0; j < index; j++)
-			{
-				if((search_code >> j) & 1)
-					crc ^= ms_parity_table[lcb_positions[j]+offset];
-			}
-			// A match
-			if(crc == error_syndrome)
-			{
-				// Remember the correction
-				correction = search_code;
-				// If over one solution then it is no solution
-				if(++found > 1)
-					break;
-			}
-			search_code--;
-		}
-		if(found == 1) // Only one valid solution
-		{
-			// Flip the bits
-			for(j = 0; j < index; j++)
-			{
-				if((correction >> j) & 1)
-				{
-					data_out[i].set_bit_flipped(lcb_positions[j]);
-				}
-			}
-			// Correct the output
-			crc = ms_check_parity(data_out[i]);
-			data_out[i].set_address(crc);
-			data_out[i].set_ec_quality(ms_frame_raw::eq_ec_corrected);
-		}
-		else if(found > 1)  // Indicate multiple solutions
-			data_out[i].set_ec_quality(ms_frame_raw::eq_ec_multiple);
-		else  // Nothing can be done
-			data_out[i].set_ec_quality(ms_frame_raw::eq_ec_na);
-
-
-	}
-	else  // Too many lcbs
-		data_out[i].set_ec_quality(ms_frame_raw::eq_ec_na);
+	if(!d_ec->quick(data_out[i]))
+		d_order.push_back(std::make_pair(2*data_out[i].lcb_count() + (data_out[i].length() == MS_LONG_FRAME_LENGTH), i));
+    }
+    std::sort(d_order.begin(), d_order.end());
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    for(k = 0; k < (int)d_order.size(); k++)
+    {
+	if((boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() >= d_budget_us)
+		break;
+	d_ec->correct(data_out[d_order[k].second]);
+    }
+    // Over the budget so pass the rest on uncorrected
+    for(; k < (int)d_order.size(); k++)
+    {
+	data_out[d_order[k].second].set_ec_quality(ms_frame_raw::eq_ec_deferred);
+	d_deferred++;
     }
     return i;
 }
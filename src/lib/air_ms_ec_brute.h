@@ -23,29 +23,61 @@
 #define INCLUDED_AIR_MS_EC_BRUTE_H
 
 #include <gr_sync_block.h>
+#include <vector>
+#include <utility>
 
 class air_ms_ec_brute;
+class ms_ec_corrector;
 typedef boost::shared_ptr<air_ms_ec_brute> air_ms_ec_brute_sptr;
 
-air_ms_ec_brute_sptr air_make_ms_ec_brute();
+air_ms_ec_brute_sptr air_make_ms_ec_brute(int max_lcbs = 12, double budget_us = 0.0, bool address_cache = false);
 
 /*!
  * \brief Mode Select Error Correction Brute Force Style
  * \ingroup block
+ *
+ * Frames with up to max_lcbs (at most 24) low confidence bits are corrected
+ * by a meet in the middle search of the low confidence bit subsets.
+ *
+ * With budget_us above zero each call of work() spends about that long on
+ * the searches.  The frames are searched in order of fewest low confidence
+ * bits and short before long, and the frames left over the budget are passed
+ * on uncorrected as eq_ec_deferred.
+ *
+ * With address_cache, frames with the address overlaid on the parity are
+ * corrected against the addresses in the shared address cache.
  */
 
 class air_ms_ec_brute : public gr_sync_block
 {
 private:
     // Constructors
-    friend air_ms_ec_brute_sptr air_make_ms_ec_brute();
-    air_ms_ec_brute();
+    friend air_ms_ec_brute_sptr air_make_ms_ec_brute(int max_lcbs, double budget_us, bool address_cache);
+    air_ms_ec_brute(int max_lcbs, double budget_us, bool address_cache);
 
+    ms_ec_corrector *d_ec;     // Frame error correction
+    double d_budget_us;        // Search time per call, unlimited if zero or less
+    std::vector<std::pair<int, int> > d_order;  // Search cost and index of the frames to search
+    unsigned long d_deferred;
 
 public:
+    ~air_ms_ec_brute();
+
     int work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items);
+
+    // Frames corrected by the one and two bit syndrome table, by the search
+    // and against the address cache
+    unsigned long table_corrections() const;
+    unsigned long search_corrections() const;
+    unsigned long address_corrections() const;
+    // Frames that took the outcome of an earlier identical frame
+    unsigned long memo_hits() const;
+    unsigned long memo_misses() const;
+    // Frames over the time budget and frames with too many low confidence bits
+    unsigned long deferred_frames() const;
+    unsigned long skipped_frames() const;
 };
 
 #endif /* INCLUDED_AIR_MS_PARITY_H */
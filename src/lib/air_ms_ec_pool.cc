@@ -0,0 +1,104 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <air_ms_ec_pool.h>
+#include <gr_io_signature.h>
+#include <air_ms_types.h>
+#include <airi_ms_ec_pool.h>
+#include <airi_ms_address.h>
+
+// Frames in the reorder buffer
+const int MS_EC_POOL_FRAMES = 1024;
+
+air_ms_ec_pool_sptr air_make_ms_ec_pool(int nthreads, int max_lcbs, double max_latency_ms, bool address_cache)
+{
+    return air_ms_ec_pool_sptr(new air_ms_ec_pool(nthreads, max_lcbs, max_latency_ms, address_cache));
+}
+
+air_ms_ec_pool::air_ms_ec_pool(int nthreads, int max_lcbs, double max_latency_ms, bool address_cache) :
+    gr_block ("ms_ec_pool",
+	gr_make_io_signature(1, 1, sizeof(ms_frame_raw)),
+	gr_make_io_signature(1, 1, sizeof(ms_frame_raw)))
+{
+    d_workers = new ms_ec_workers(nthreads, max_lcbs, MS_EC_POOL_FRAMES, max_latency_ms,
+	address_cache ? &ms_address_cache::shared() : 0);
+}
+
+air_ms_ec_pool::~air_ms_ec_pool()
+{
+    delete d_workers;
+}
+
+void air_ms_ec_pool::forecast (int noutput_items,
+	       gr_vector_int &ninput_items_required)
+{
+	// Frames in the pool can go out with no more input
+	ninput_items_required[0] = d_workers->pending() ? 0 : noutput_items;
+}
+
+int air_ms_ec_pool::general_work(int noutput_items,
+		                gr_vector_int &ninput_items,
+		                gr_vector_const_void_star &input_items,
+	                        gr_vector_void_star &output_items)
+{
+    const ms_frame_raw *data_in = (const ms_frame_raw *)input_items[0];
+    ms_frame_raw *data_out = (ms_frame_raw *)output_items[0];
+
+    int i = 0;
+    int out = 0;
+    int space = d_workers->space();
+    for(i = 0; (i < ninput_items[0]) && (i < space); i++)
+	d_workers->push(data_in[i]);
+    // Take the done frames, and wait for the oldest if nothing else moved
+    while((out < noutput_items) && d_workers->pop(data_out[out], (i == 0) && (out == 0)))
+	out++;
+    consume_each(i);
+    return out;
+}
+
+int air_ms_ec_pool::queue_depth() const
+{
+    return d_workers->queue_depth();
+}
+
+int air_ms_ec_pool::max_queue_depth() const
+{
+    return d_workers->max_queue_depth();
+}
+
+int air_ms_ec_pool::reorder_depth() const
+{
+    return d_workers->pending();
+}
+
+unsigned long air_ms_ec_pool::fast_frames() const
+{
+    return d_workers->fast_frames();
+}
+
+unsigned long air_ms_ec_pool::late_frames() const
+{
+    return d_workers->late_frames();
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_EC_POOL_H
+#define INCLUDED_AIR_MS_EC_POOL_H
+
+#include <gr_block.h>
+
+class air_ms_ec_pool;
+class ms_ec_workers;
+typedef boost::shared_ptr<air_ms_ec_pool> air_ms_ec_pool_sptr;
+
+air_ms_ec_pool_sptr air_make_ms_ec_pool(int nthreads, int max_lcbs = 12, double max_latency_ms = 100.0, bool address_cache = false);
+
+/*!
+ * \brief Mode Select Error Correction on a pool of worker threads
+ * \ingroup block
+ *
+ * Does the same correction as ms_ec_brute on nthreads worker threads so a
+ * frame with many low confidence bits does not hold up the frames behind it.
+ * Frames come out in the order they came in.  A frame not corrected within
+ * max_latency_ms of coming in is passed on uncorrected as eq_ec_deferred,
+ * zero or less waits for every frame.  With nthreads zero the frames are
+ * corrected in the scheduler thread.  address_cache is as for ms_ec_brute.
+ */
+class air_ms_ec_pool : public gr_block
+{
+private:
+    friend air_ms_ec_pool_sptr air_make_ms_ec_pool(int nthreads, int max_lcbs, double max_latency_ms, bool address_cache);
+    air_ms_ec_pool(int nthreads, int max_lcbs, double max_latency_ms, bool address_cache);
+
+    ms_ec_workers *d_workers;    // Worker threads and reorder buffer
+
+public:
+    ~air_ms_ec_pool();
+    void forecast (int noutput_items,
+		   gr_vector_int &ninput_items_required);
+
+    int general_work (int noutput_items,
+		      gr_vector_int &ninput_items,
+		      gr_vector_const_void_star &input_items,
+		      gr_vector_void_star &output_items);
+
+    // Counters
+    int queue_depth() const;            // Frames queued or being corrected
+    int max_queue_depth() const;
+    int reorder_depth() const;          // Frames waiting to go out
+    unsigned long fast_frames() const;  // Frames that needed no search
+    unsigned long late_frames() const;  // Frames passed on as eq_ec_deferred
+};
+
+#endif /* INCLUDED_AIR_MS_EC_POOL_H */
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <air_ms_fmt_binlog.h>
+#include <gr_io_signature.h>
+#include <air_ms_types.h>
+#include <air_ms_binlog.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdexcept>
+
+air_ms_fmt_binlog_sptr air_make_ms_fmt_binlog(int pass_all, const char *filename, int buffer_records)
+{
+    return air_ms_fmt_binlog_sptr(new air_ms_fmt_binlog(pass_all, filename, buffer_records));
+}
+
+air_ms_fmt_binlog::air_ms_fmt_binlog(int pass_all, const char *filename, int buffer_records) :
+    gr_sync_block("ms_fmt_binlog",
+    gr_make_io_signature(1, 1, sizeof(ms_frame_raw)),
+    gr_make_io_signature(0, 0, 0)),
+        d_used(0), d_count(0), d_pass_all(pass_all)
+{
+    d_buffer.resize((size_t)((buffer_records > 0) ? buffer_records : 1) * MS_BINLOG_RECORD_SIZE);
+    // Like gr_file_sink a log that cannot be written is an error in the constructor
+    std::string error;
+    d_fd = ms_binlog_open(filename, error);
+    if(d_fd < 0)
+    {
+	fprintf(stderr, "%s\n", error.c_str());
+	throw std::runtime_error(error);
+    }
+}
+
+air_ms_fmt_binlog::~air_ms_fmt_binlog()
+{
+    flush();
+    close(d_fd);
+}
+
+bool air_ms_fmt_binlog::flush()
+{
+    bool ok = ms_binlog_write(d_fd, &d_buffer[0], d_used);
+    if(!ok)
+	perror("ms_fmt_binlog");
+    d_used = 0;
+    return ok;
+}
+
+bool air_ms_fmt_binlog::stop()
+{
+    flush();
+    return true;
+}
+
+int air_ms_fmt_binlog::work(int noutput_items,
+    gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items)
+{
+    const ms_frame_raw *data_in = (const ms_frame_raw *)input_items[0];
+
+    int i;
+    for(i = 0;i < noutput_items; i++)
+    {
+        // If pass all or data good then log it otherwise move on
+        if(d_pass_all || (data_in[i].ec_quality() & (ms_frame_raw::crc_ok | ms_frame_raw::eq_ec_corrected)))
+        {
+            ms_binlog_encode(data_in[i], &d_buffer[d_used]);
+            d_used += MS_BINLOG_RECORD_SIZE;
+            d_count++;
+            if((d_used == d_buffer.size()) && !flush())
+                return -1;  // Done, the log can not be written
+        }
+    }
+
+    return i;
+}
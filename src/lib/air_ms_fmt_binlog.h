@@ -0,0 +1,66 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_FMT_BINLOG_H
+#define INCLUDED_AIR_MS_FMT_BINLOG_H
+
+#include <gr_sync_block.h>
+#include <vector>
+
+class air_ms_fmt_binlog;
+typedef boost::shared_ptr<air_ms_fmt_binlog> air_ms_fmt_binlog_sptr;
+
+air_ms_fmt_binlog_sptr air_make_ms_fmt_binlog(int pass_all, const char *filename, int buffer_records = 16384);
+
+/*!
+ * \brief Mode Select Binary Log Writer
+ * \ingroup block
+ *
+ * Appends the frames to filename as the fixed size records of air_ms_binlog.h
+ * so nothing is formatted or queued while the flow graph runs.  The
+ * records are written buffer_records at a time and when the flow graph stops.
+ * A new file is given the header first; an existing log must be one this
+ * version writes and a record cut short at its end is dropped.  pass_all is
+ * as for ms_fmt_log.  ms_binlog2txt turns the log into ms_fmt_log text.
+ */
+class air_ms_fmt_binlog : public gr_sync_block
+{
+private:
+    // Constructors
+    friend air_ms_fmt_binlog_sptr air_make_ms_fmt_binlog(int pass_all, const char *filename, int buffer_records);
+    air_ms_fmt_binlog(int pass_all, const char *filename, int buffer_records);
+
+    int d_fd;                            // Log file
+    std::vector<unsigned char> d_buffer; // Records not written yet
+    size_t d_used;                       // Bytes of d_buffer in use
+    int d_count;                         // Count of logged frames
+    int d_pass_all;                      // Pass all frames if no zero
+    bool flush();
+
+public:
+    ~air_ms_fmt_binlog();
+    bool stop();
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+};
+
+#endif /* INCLUDED_AIR_MS_FMT_BINLOG_H */
@@ -37,12 +37,12 @@ PI is the parity bits of both the short and long frames and represents the last
 
 Ref Lv is the Reference Level used and can be used as a RSSI.
 
-TS is the sample number.  It will roll over after a short period of time.  It represnets the preample
-   start sample and may be useful to determine short time differences between Mode S Frames.
+TS is the 64 bit sample number of the data start, it takes more than eight digits after 2^32 samples.
+   It may be useful to determine short time differences between Mode S Frames.
 
-Time is the decode time using the unix time() function (Seconds since Jan 1, 1970)  It represents when
-the whole frame was received and processed.  This may be useful for the standard 5 minute delay when sending
-information on the internet
+Time is the time of the data start in seconds since Jan 1, 1970.  It comes from the rx_time tags of a UHD
+source, or from the system clock at the first frame, and the sample count.  This may be useful for the
+standard 5 minute delay when sending information on the internet
 
 LCB is the number of Low Confidence Bits in the frame
 
@@ -63,6 +63,7 @@ in a short period of time.
 #include <air_ms_fmt_log.h>
 #include <gr_io_signature.h>
 #include <air_ms_types.h>
+#include <airi_ms_fmt_text.h>
 #include <ctype.h>
 #include <iostream>
 
@@ -103,83 +104,9 @@ int air_ms_fmt_log::work(int noutput_items,
 
 void air_ms_fmt_log::format_data(ms_frame_raw &frame)
 {
-    int i;
-    int typecode = 0;
-    int data = 0;
-    int pi = 0;
-    for (i = 0; i < 5; i++)
-    {
-       typecode = (typecode << 1) + frame.bit(i);
-       data = (data << 1) + frame.bit(i);
-    }
-    for (i = 5; i < 32; i++)
-    {
-        data = (data << 1) + frame.bit(i);
-    }
-
-    d_payload.str("");
-    d_payload.width(8);
-    d_payload.fill('0');
-    d_payload << std::hex <<  data << FIELD_DELIM;
-
-    if(frame.length() >= MS_LONG_FRAME_LENGTH)
-    {
-        data = 0;
-        d_payload.width(7);
-        for (i = 32; i < 60; i++)
-        {
-             data = (data << 1) + frame.bit(i);
-        }
-        d_payload << data;
-        data = 0;
-        d_payload.width(7);
-        for (i = 60; i < 88; i++)
-        {
-             data = (data << 1) + frame.bit(i);
-        }
-        d_payload << data << FIELD_DELIM;
-        d_payload.width(6);
-        for (i = 88; i < MS_LONG_FRAME_LENGTH; i++)
-        {
-             pi = (pi << 1) + frame.bit(i);
-        }
-        d_payload << pi << FIELD_DELIM;
-    }
-    else
-    {
-        for (i = 32; i < MS_SHORT_FRAME_LENGTH; i++)
-        {
-             pi = (pi << 1) + frame.bit(i);
-        }
-        d_payload << FIELD_DELIM << "             " << FIELD_DELIM;
-        d_payload.width(6);
-        d_payload << pi << FIELD_DELIM;
-    }
-    
-    d_payload.width(7);
-    d_payload.precision(5);
-    d_payload.fill(' ');
-    d_payload << std::dec << frame.reference() << FIELD_DELIM;
-    
-    d_payload.width(8);
-    d_payload.fill('0');
-    d_payload << std::hex << frame.timestamp() << FIELD_DELIM << frame.rx_time() << FIELD_DELIM;
-    
-    d_payload.width(3);
-    d_payload.fill(' ');
-    d_payload << std::dec << frame.lcb_count() << FIELD_DELIM;
-    
-    d_payload.width(8);
-    d_payload.fill('0');
-    d_payload << std::hex << frame.ec_quality() << FIELD_DELIM;
-    
-    d_payload.width(2);
-    d_payload << std::dec << typecode << FIELD_DELIM;
-    
-    d_payload.width(6);
-    d_payload << std::hex << frame.address();
-
-    gr_message_sptr msg = gr_make_message_from_string(std::string(d_payload.str()));
+    char line[MS_FMT_TEXT_MAX];
+    int n = ms_fmt_text(frame, line);
+    gr_message_sptr msg = gr_make_message_from_string(std::string(line, n));
     d_queue->handle(msg);
 }
 
@@ -24,7 +24,6 @@
 
 #include <gr_sync_block.h>
 #include <gr_msg_queue.h>
-#include <sstream>
 
 class air_ms_fmt_log;
 class ms_frame_raw;
@@ -37,8 +36,6 @@ air_ms_fmt_log_sptr air_make_ms_fmt_log(int pass_all, gr_msg_queue_sptr queue);
  * \ingroup block
  */
 
-#define FIELD_DELIM ((unsigned char)32)
-
 class air_ms_fmt_log : public gr_sync_block
 {
 private:
@@ -46,7 +43,6 @@ private:
     friend air_ms_fmt_log_sptr air_make_ms_fmt_log(int pass_all, gr_msg_queue_sptr queue);
     air_ms_fmt_log(int pass_all, gr_msg_queue_sptr queue);
 
-    std::ostringstream d_payload;
     gr_msg_queue_sptr d_queue;		  // Destination for decoded mode S
 
     int d_count;	                  // Count of logged codewords
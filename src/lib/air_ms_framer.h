@@ -23,8 +23,10 @@
 #define INCLUDED_AIR_MS_FRAMER_H
 
 #include <gr_sync_block.h>
+#include <vector>
 
 class air_ms_framer;
+template <int RATE> class ms_framer_kernel;
 typedef boost::shared_ptr<air_ms_framer> air_ms_framer_sptr;
 
 air_ms_framer_sptr air_make_ms_framer(int channel_rate);
@@ -32,6 +34,9 @@ air_ms_framer_sptr air_make_ms_framer(int channel_rate);
 /*!
  * \brief mode select framer
  * \ingroup block
+ *
+ * Input is the samples and the attributes from the preamble detection, output
+ * is the attributes only with the data start and end marked.
  */
 class air_ms_framer : public gr_sync_block
 {
@@ -42,15 +47,16 @@ private:
     float d_reference;   // current reference level
     int d_channel_rate;  // Sample rate of the streams
     int d_data_start;        // When the data starts in samples
-    int d_check_width;   // Width of Preamble checking in samples
-    int d_chip_width;    // Width of chip (1/2 bit time) in samples
-    int d_bit_width;     // Width of bit in samples
-    int d_var_n;         // Number of samples to use after a leading edge
-    int d_var_m;         // d_var_n plus trailing edge
-    int d_min_frame_width;  // length of short frame in samples
     int d_max_frame_width;  // length of long frame in samples
+    ms_framer_kernel<0> *d_kernel;  // Frame length, the build for any rate (MS_RATE_RUNTIME)
+    pmt::pmt_t d_preamble_ref_key;  // Tag key for the reference at a preamble start
+    pmt::pmt_t d_data_ref_key;      // Tag key for the reference at a data start
+    std::vector<gr_tag_t> d_tags;   // Preamble references in the current work call
+
+    float preamble_reference(uint64_t offset);
 
 public:
+    ~air_ms_framer();
     int work (int noutput_items,
               gr_vector_const_void_star &input_items,
               gr_vector_void_star &output_items);
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <air_ms_log_sink.h>
+#include <gr_io_signature.h>
+#include <air_ms_types.h>
+#include <air_ms_binlog.h>
+#include <airi_ms_fmt_text.h>
+#include <airi_ms_log_writer.h>
+#include <stdio.h>
+#include <stdexcept>
+
+air_ms_log_sink_sptr air_make_ms_log_sink(int pass_all, const char *filename, bool binary,
+                                          int sync, double rotate_mb, double rotate_seconds,
+                                          double flush_seconds, int buffer_kb)
+{
+    return air_ms_log_sink_sptr(new air_ms_log_sink(pass_all, filename, binary, sync, rotate_mb,
+                                                    rotate_seconds, flush_seconds, buffer_kb));
+}
+
+air_ms_log_sink::air_ms_log_sink(int pass_all, const char *filename, bool binary, int sync, double rotate_mb,
+                                 double rotate_seconds, double flush_seconds, int buffer_kb) :
+    gr_sync_block("ms_log_sink",
+    gr_make_io_signature(1, 1, sizeof(ms_frame_raw)),
+    gr_make_io_signature(0, 0, 0)),
+        d_binary(binary), d_count(0), d_pass_all(pass_all)
+{
+    d_writer = new ms_log_writer(filename, binary, sync, (uint64_t)(rotate_mb * 1048576.0),
+                                 rotate_seconds, flush_seconds, (size_t)buffer_kb * 1024);
+    // Like gr_file_sink a log that cannot be written is an error in the constructor
+    if(!d_writer->ok())
+    {
+	std::string error = d_writer->error();
+	delete d_writer;
+	fprintf(stderr, "%s\n", error.c_str());
+	throw std::runtime_error(error);
+    }
+}
+
+air_ms_log_sink::~air_ms_log_sink()
+{
+    delete d_writer;
+}
+
+bool air_ms_log_sink::stop()
+{
+    d_writer->flush();
+    return true;
+}
+
+unsigned long long air_ms_log_sink::bytes() const
+{
+    return d_writer->bytes();
+}
+
+unsigned long air_ms_log_sink::files() const
+{
+    return d_writer->files();
+}
+
+unsigned long air_ms_log_sink::waits() const
+{
+    return d_writer->waits();
+}
+
+int air_ms_log_sink::work(int noutput_items,
+    gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items)
+{
+    const ms_frame_raw *data_in = (const ms_frame_raw *)input_items[0];
+
+    int i;
+    for(i = 0;i < noutput_items; i++)
+    {
+        // If pass all or data good then log it otherwise move on
+        if(!d_pass_all && !(data_in[i].ec_quality() & (ms_frame_raw::crc_ok | ms_frame_raw::eq_ec_corrected)))
+            continue;
+        bool ok;
+        if(d_binary)
+        {
+            unsigned char record[MS_BINLOG_RECORD_SIZE];
+            ms_binlog_encode(data_in[i], record);
+            ok = d_writer->write((const char *)record, sizeof(record));
+        }
+        else
+        {
+            char line[MS_FMT_TEXT_MAX + 1];
+            int n = ms_fmt_text(data_in[i], line);
+            line[n++] = '\n';
+            ok = d_writer->write(line, n);
+        }
+        if(!ok)
+            return -1;  // Done, the log can not be written
+        d_count++;
+    }
+
+    return i;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_LOG_SINK_H
+#define INCLUDED_AIR_MS_LOG_SINK_H
+
+#include <gr_sync_block.h>
+
+class air_ms_log_sink;
+class ms_log_writer;
+typedef boost::shared_ptr<air_ms_log_sink> air_ms_log_sink_sptr;
+
+air_ms_log_sink_sptr air_make_ms_log_sink(int pass_all, const char *filename, bool binary = false,
+                                          int sync = 1, double rotate_mb = 0.0, double rotate_seconds = 0.0,
+                                          double flush_seconds = 1.0, int buffer_kb = 1024);
+
+/*!
+ * \brief Mode Select Log File
+ * \ingroup block
+ *
+ * Appends the frames to filename as the ms_fmt_log text lines, or with binary
+ * the records of ms_fmt_binlog, without going through a message queue.  The
+ * lines are written by a thread of the block's own from two buffer_kb buffers.
+ * Frames reach the file within flush_seconds, zero waits for a full buffer,
+ * and when the flow graph stops.  sync 0 leaves syncing to the system, 1
+ * syncs a file when it is rotated or closed and 2 after every write.  With
+ * rotate_mb or rotate_seconds not zero the file is renamed with the time and a
+ * new one started when it would go over rotate_mb or is rotate_seconds old.
+ * pass_all is as for ms_fmt_log.
+ */
+class air_ms_log_sink : public gr_sync_block
+{
+private:
+    // Constructors
+    friend air_ms_log_sink_sptr air_make_ms_log_sink(int pass_all, const char *filename, bool binary,
+                                                     int sync, double rotate_mb, double rotate_seconds,
+                                                     double flush_seconds, int buffer_kb);
+    air_ms_log_sink(int pass_all, const char *filename, bool binary, int sync, double rotate_mb,
+                    double rotate_seconds, double flush_seconds, int buffer_kb);
+
+    ms_log_writer *d_writer;             // Buffers and the writer thread
+    bool d_binary;
+    int d_count;                         // Count of logged frames
+    int d_pass_all;                      // Pass all frames if no zero
+
+public:
+    ~air_ms_log_sink();
+    bool stop();
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+    // Counters
+    unsigned long long bytes() const;   // Bytes written
+    unsigned long files() const;        // Files rotated
+    unsigned long waits() const;        // Times the block waited for the writer
+};
+
+#endif /* INCLUDED_AIR_MS_LOG_SINK_H */
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_MAG_PULSE_DETECT_S_H
+#define INCLUDED_AIR_MS_MAG_PULSE_DETECT_S_H
+
+#include <gr_sync_block.h>
+#include <vector>
+
+class air_ms_mag_pulse_detect_s;
+typedef boost::shared_ptr<air_ms_mag_pulse_detect_s> air_ms_mag_pulse_detect_s_sptr;
+
+air_ms_mag_pulse_detect_s_sptr air_make_ms_mag_pulse_detect_s(float alpha, float beta, int width, float scale);
+
+/*!
+ * \brief mode select magnitude and pulse detect to fixed point
+ * \ingroup block
+ *
+ * Same as ms_mag_pulse_detect, and detects the same pulses, but the magnitude
+ * out is unsigned short, scale times the magnitude rounded and limited to
+ * 65535, for ms_demod_s.
+ */
+class air_ms_mag_pulse_detect_s : public gr_sync_block
+{
+private:
+    friend air_ms_mag_pulse_detect_s_sptr air_make_ms_mag_pulse_detect_s(float alpha, float beta, int width, float scale);
+    air_ms_mag_pulse_detect_s(float alpha, float beta, int width, float scale);
+
+    float d_alpha;      // Attack constant used to test if pulse edge
+    float d_beta;       // Threshold
+    float d_beta_sq;    // Threshold in magnitude squared
+    int d_width;        // width of valid pulse in samples minus 2 for edges
+    float d_scale;      // Fixed point units per unit of magnitude
+    std::vector<float> d_mag;          // Magnitude before conversion
+    std::vector<unsigned int> d_over;  // Bitmap of samples at or above threshold
+
+public:
+    int work (int noutput_items,
+              gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items);
+};
+
+#endif /* INCLUDED_AIR_MS_MAG_PULSE_DETECT_S_H */
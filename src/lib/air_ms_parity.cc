@@ -25,21 +25,52 @@
 
 #include <air_ms_parity.h>
 #include <airi_ms_parity.h>
+#include <airi_ms_address.h>
+#include <airi_ms_framer.h>
 #include <gr_io_signature.h>
 #include <air_ms_types.h>
 
-air_ms_parity_sptr air_make_ms_parity()
+air_ms_parity_sptr air_make_ms_parity(bool address_cache)
 {
-    return air_ms_parity_sptr(new air_ms_parity());
+    return air_ms_parity_sptr(new air_ms_parity(address_cache));
 }
 
-air_ms_parity::air_ms_parity() :
+air_ms_parity::air_ms_parity(bool address_cache) :
     gr_sync_block("ms_parity",
 	gr_make_io_signature(1, 1, sizeof(ms_frame_raw)),
-	gr_make_io_signature(1, 1, sizeof(ms_frame_raw)))
+	gr_make_io_signature(1, 1, sizeof(ms_frame_raw))),
+    d_cache(address_cache ? &ms_address_cache::shared() : 0)
 {
 }
 
+unsigned long air_ms_parity::cache_lookups() const
+{
+    return d_cache ? d_cache->lookups() : 0;
+}
+
+unsigned long air_ms_parity::cache_hits() const
+{
+    return d_cache ? d_cache->hits() : 0;
+}
+
+unsigned long air_ms_parity::cache_probes() const
+{
+    return d_cache ? d_cache->probes() : 0;
+}
+
+unsigned long air_ms_parity::cache_inserts() const
+{
+    return d_cache ? d_cache->inserts() : 0;
+}
+
+// The framer took the length from the downlink format unless one of its bits
+// is of low confidence, and the format says long
+static bool ms_df_long_frame(const ms_frame_raw &frame)
+{
+    return !(frame.lcbs()[0] >> (8 - MS_DF_LENGTH)) &&
+	(ms_df_frame_length(ms_downlink_format(frame)) == MS_LONG_FRAME_LENGTH);
+}
+
 int air_ms_parity::work(int noutput_items,
     gr_vector_const_void_star &input_items,
     gr_vector_void_star &output_items)
@@ -51,7 +82,6 @@ int air_ms_parity::work(int noutput_items,
     int i, j;
     for (i = 0; i < noutput_items; i++) {
 	data_out[i] = data_in[i];
-        data_out[i].count_lcbs();
 	crc = ms_check_parity(data_out[i]);
 	data_out[i].set_address(crc);  // assume error syndrome is address overlay
 	// If the crc is good then we are done.  ACAS/TCAS Frames have a address of zero.
@@ -64,12 +94,13 @@ int air_ms_parity::work(int noutput_items,
 		if(data_out[i].length() == MS_LONG_FRAME_LENGTH)
 		{
 			//See if the frame should be a short one so check if all low energy bits are in second half
-			if ((data_out[i].lcb_count() >= MS_SHORT_FRAME_LENGTH) && (data_out[i].first_leb() >= MS_SHORT_FRAME_LENGTH))
+			// unless the length came from a long downlink format
+			if ((data_out[i].lcb_count() >= MS_SHORT_FRAME_LENGTH) && (data_out[i].first_leb() >= MS_SHORT_FRAME_LENGTH) &&
+			    !ms_df_long_frame(data_out[i]))
 			{
 				data_out[i].set_short_frame();
 				crc = ms_check_parity(data_out[i]);
 				data_out[i].set_address(crc);  // assume error syndrome is address overlay
-                                data_out[i].count_lcbs();
 				if(crc == 0)  // address is zero (ACAS/TCAS)
 				{
 					data_out[i].set_ec_quality((ms_frame_raw::crc_ok|ms_frame_raw::eq_change_short_frame));
@@ -127,5 +158,15 @@ int air_ms_parity::work(int noutput_items,
 		}
 	}
     }
+    // The syndrome is in the address.  Zero gives an address for the cache and
+    // anything else on a good frame is an address overlay to look up
+    for (j = 0; d_cache && (j < i); j++) {
+	if(!(data_out[j].ec_quality() & ms_frame_raw::crc_ok))
+		continue;
+	if(data_out[j].address() == 0)
+		d_cache->insert(ms_announced_address(data_out[j]), data_out[j].rx_time());
+	else if(ms_address_parity_format(ms_downlink_format(data_out[j])) && d_cache->contains(data_out[j].address(), data_out[j].rx_time()))
+		data_out[j].set_ec_quality(data_out[j].ec_quality() | ms_frame_raw::eq_ap_cached);
+    }
     return i;
 }
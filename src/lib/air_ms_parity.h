@@ -25,26 +25,39 @@
 #include <gr_sync_block.h>
 
 class air_ms_parity;
+class ms_address_cache;
 typedef boost::shared_ptr<air_ms_parity> air_ms_parity_sptr;
 
-air_ms_parity_sptr air_make_ms_parity();
+air_ms_parity_sptr air_make_ms_parity(bool address_cache = false);
 
 /*!
  * \brief Mode Select Parity Check
  * \ingroup block
+ *
+ * With address_cache the addresses of DF11/17/18 frames with good parity are
+ * put in the shared address cache, and frames with the address overlaid on
+ * the parity are marked eq_ap_cached when the overlay is a cached address.
  */
 
 class air_ms_parity : public gr_sync_block
 {
 private:
     // Constructors
-    friend air_ms_parity_sptr air_make_ms_parity();
-    air_ms_parity();
+    friend air_ms_parity_sptr air_make_ms_parity(bool address_cache);
+    air_ms_parity(bool address_cache);
+
+    ms_address_cache *d_cache;			// Shared address cache or null
 
 public:
     int work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items);
+
+    // Address cache counters
+    unsigned long cache_lookups() const;
+    unsigned long cache_hits() const;
+    unsigned long cache_probes() const;   // Cache entries read by the lookups
+    unsigned long cache_inserts() const;
 };
 
 #endif /* INCLUDED_AIR_MS_PARITY_H */
@@ -24,9 +24,12 @@
 #include "config.h"
 #endif
 
+#include <algorithm>
 #include <gr_io_signature.h>
 #include <air_ms_types.h>
 #include <air_ms_ppm_decode.h>
+#include <airi_ms_ppm.h>
+#include <airi_ms_clock.h>
 
 air_ms_ppm_decode_sptr air_make_ms_ppm_decode(int channel_rate)
 {
@@ -40,15 +43,16 @@ air_ms_ppm_decode::air_ms_ppm_decode(int channel_rate) :
 {
     d_channel_rate = channel_rate;
     d_reference = 0.0;
-    d_high_limit = 0.0;
-    d_low_limit = 0.0;
-    d_low_energy_limit = 0.0;
     d_data_start = MS_PREAMBLE_TIME_US * channel_rate / 1000000; // in uS
     d_bit_width = MS_BIT_TIME_US * channel_rate / 1000000;
     d_chip_width = d_bit_width / 2;   // Two Chips per bit
     d_min_data_width =  MS_BIT_TIME_US * MS_SHORT_FRAME_LENGTH * channel_rate / 1000000; // in uS
     d_max_data_width =  MS_BIT_TIME_US * MS_LONG_FRAME_LENGTH * channel_rate / 1000000;
     d_sample_count = 0;
+    d_slicer = new ms_ppm_slicer<MS_RATE_RUNTIME>(channel_rate);
+    d_clock = new ms_sample_clock(channel_rate);
+    d_data_ref_key = pmt::pmt_string_to_symbol(MS_TAG_DATA_REF);
+    d_rx_time_key = pmt::pmt_string_to_symbol(MS_TAG_RX_TIME);
 
     //  Mode S frames are sent in a burst of one frame that occurs when the Mode S transponder is interrogated
     //  by the ground or other aircraft (ACAS/TCAS).  ADS-B Frames may also be sent once per second.
@@ -58,6 +62,12 @@ air_ms_ppm_decode::air_ms_ppm_decode(int channel_rate) :
     // set_output_multiple(2*(d_max_data_width+2));
 }
 
+air_ms_ppm_decode::~air_ms_ppm_decode()
+{
+    delete d_slicer;
+    delete d_clock;
+}
+
 void air_ms_ppm_decode::forecast (int noutput_items,
 	       gr_vector_int &ninput_items_required)
 {
@@ -66,6 +76,17 @@ void air_ms_ppm_decode::forecast (int noutput_items,
 	ninput_items_required[1] = ninput_items_required[0] = size;
 }
 
+// Find the reference level tagged at a data start
+float air_ms_ppm_decode::data_reference(uint64_t offset)
+{
+    gr_tag_t key;
+    key.offset = offset;
+    std::vector<gr_tag_t>::iterator t = std::lower_bound(d_tags.begin(), d_tags.end(), key, gr_tag_t::offset_compare);
+    if((t == d_tags.end()) || (t->offset != offset))
+	return 0.0;
+    return pmt::pmt_to_double(t->value);
+}
+
 int air_ms_ppm_decode::general_work(int noutput_items,
 		                gr_vector_int &ninput_items,
 		                gr_vector_const_void_star &input_items,
@@ -77,13 +98,18 @@ int air_ms_ppm_decode::general_work(int noutput_items,
     ms_frame_raw *data_out = (ms_frame_raw *) output_items[0];  // sample data out
 
     int size = ninput_items[0] - (d_max_data_width+2); // Only search up to a frame from the end
-    int i, j, k;
+    int i;
     int out_count;
     int bit_index = 0;
     int frame_end = 0;
-    float f;
+    int data_end;
+    uint64_t nread = nitems_read(1);
     out_count = 0;
-    j = 0;
+    get_tags_in_range(d_tags, 1, nread, nread + ninput_items[1], d_data_ref_key);
+    std::sort(d_tags.begin(), d_tags.end(), gr_tag_t::offset_compare);
+    get_tags_in_range(d_time_tags, 0, nread, nread + ninput_items[0], d_rx_time_key);
+    std::sort(d_time_tags.begin(), d_time_tags.end(), gr_tag_t::offset_compare);
+    d_clock->add_tags(d_time_tags);
     for (i = 0; (i < size) && (out_count < noutput_items); i++)
     {
 	// Ignore any preamble starts and look for data start
@@ -91,120 +117,17 @@ int air_ms_ppm_decode::general_work(int noutput_items,
 	if(attrib_in[i].data_start())
 	{
 		// Calculate the reference and limits
-		d_reference = attrib_in[i].reference();
-		d_high_limit = d_reference * 1.41253;  // + 3 dB
-		d_low_limit = d_reference * 0.70795;  // - 3 dB
-                d_low_energy_limit = d_reference * 0.5012;  // -6 dB
+		d_reference = data_reference(nread + i);
                 // Prep an output frame
 		data_out[out_count].reset_all();
-		data_out[out_count].set_rx_time(time(NULL));
-		data_out[out_count].set_timestamp((d_sample_count + i));
+		data_out[out_count].set_timestamp(d_sample_count + i);
+		data_out[out_count].set_rx_time_ns(d_clock->time_ns(d_sample_count + i));
 		data_out[out_count].set_reference(d_reference);
-		// Init variables used in loop
-	        bit_index = 0;
-		frame_end = 0;
-		int multiplier = 1;
-		int phase = 0;  // Data bit phase
-		int chip_zero_ok = 0;
-		int chip_zero_low_energy = 0;
-		int chip_one_ok = 0;
-		int chip_one_low_energy = 0;
-		int score_zero = 0;
-		int score_one = 0;
-		int score_low_energy;
-		// Go for up to the Maximum Frame length for the data bits
-                // It is possible that noise could skew the phase enough that the buffer runs out so test input size as well
-		for(bit_index = 0; (i < ninput_items[0]) && (bit_index < MS_LONG_FRAME_LENGTH); i++)
-		{
-			// If leading edge is a sample time late resync
-			if((phase == 1) && attrib_in[i].leading_edge())
-			{
-                        	phase--;
-				chip_one_ok = 0;   // Might as well reset
-				chip_one_low_energy = 0;
-			}
-			// If leading edge is a sample time early resync
-			if((phase == 3) && attrib_in[i].leading_edge())
-			{
-                        	phase++;
-			}
-			// If leading edge is a sample time late resync
-			if((phase == (d_chip_width+1)) && attrib_in[i].leading_edge())
-			{
-                        	phase--;
-				chip_zero_ok = 0;  // Might as well reset
-				chip_zero_low_energy = 0;
-			}
-			// If leading edge is a sample time late resync
-			if((phase == 7) && attrib_in[i].leading_edge())
-			{
-                        	phase++;
-			}
-			// the middle of the pulses have more weight than the edges
-			if((phase == 0) ||(phase == (d_chip_width-1)) ||
-			   (phase == d_chip_width) ||(phase >= (d_bit_width-1)))
-				multiplier = 1;
-			else
-				multiplier = 2;
-                        // Score the samples that represent a valid level and a low energy level
-			if(phase < d_chip_width)   // the first chip represents a data value of one
-			{
-				f = data_in[i];
-				if(f >= d_low_limit && f <= d_high_limit)
-					chip_one_ok += multiplier;
-				else if(f < d_low_energy_limit)
-					chip_one_low_energy += multiplier;
-			}
-			else if(phase < d_bit_width)  // the second chip represents a data value of zero
-			{
-				f = data_in[i];
-				if(f >= d_low_limit && f <= d_high_limit)
-					chip_zero_ok += multiplier;
-				else if(f < d_low_energy_limit)
-					chip_zero_low_energy += multiplier;
-			}
-			if(++phase >= d_bit_width)
-			{
-				// Decide what the bit is.  Tie scores go to the zero
-				score_one = chip_one_ok - chip_zero_ok + chip_zero_low_energy - chip_one_low_energy;
-				score_zero = chip_zero_ok - chip_one_ok + chip_one_low_energy - chip_zero_low_energy;
-				score_low_energy = chip_one_low_energy + chip_zero_low_energy - chip_one_ok - chip_zero_ok;
-				k = abs(score_one - score_zero);
-				if(k > 2)  // Bit has high confidence
-				{
-					data_out[out_count].set_bit_high_confidence(bit_index, (score_one > score_zero)?1:0);
-				}
-				else if(k > 0)  // Bit has a low confidence
-				{
-					data_out[out_count].set_bit_low_confidence(bit_index, (score_one > score_zero)?1:0);
-				}
-				else if(chip_zero_low_energy >= 6)  // both chips are equal as k == 0
-				{
-					data_out[out_count].set_bit_low_energy(bit_index, (score_one > score_zero)?1:0);
-				}
-				else
-				{
-					data_out[out_count].set_bit_low_confidence(bit_index, 0);
-				}
-				if(frame_end)
-					break;  // Fall to data end block below
-				phase = 0;
-				chip_zero_ok = 0;
-				chip_zero_low_energy = 0;
-				chip_one_ok = 0;
-				chip_one_low_energy = 0;
-				score_zero = 0;
-				score_one = 0;
-				bit_index++;
-			}
-			if(attrib_in[i].data_end())
-			{
-				if(phase == 0)
-					break;  // Fall to data end block below
-				else  // complete the bit
-					frame_end++;
-			}
-		}
+		// Slice up to the frame end marked by the framer
+		for(data_end = i; (data_end < ninput_items[0]) && !attrib_in[data_end].data_end(); data_end++)
+			;
+		i = d_slicer->slice(data_in, attrib_in, i, ninput_items[0], data_end, d_reference,
+		                    data_out[out_count], bit_index, frame_end);
 	}
 	// If frame has ended send the output
 	if(attrib_in[i].data_end() || frame_end)
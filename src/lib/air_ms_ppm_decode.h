@@ -23,8 +23,11 @@
 #define INCLUDED_AIR_MS_PPM_DECODE_H
 
 #include <gr_block.h>
+#include <vector>
 
 class air_ms_ppm_decode;
+template <int RATE> class ms_ppm_slicer;
+class ms_sample_clock;
 typedef boost::shared_ptr<air_ms_ppm_decode> air_ms_ppm_decode_sptr;
 
 air_ms_ppm_decode_sptr air_make_ms_ppm_decode(int channel_rate);
@@ -40,18 +43,24 @@ private:
     air_ms_ppm_decode(int channel_rate);
 
     float d_reference;   // current reference level
-    float d_high_limit;
-    float d_low_limit;
-    float d_low_energy_limit;
     int d_channel_rate;  // Sample rate of the streams
     int d_data_start;
     int d_chip_width;
     int d_bit_width;
     int d_min_data_width;
     int d_max_data_width;
-    int d_sample_count;
+    uint64_t d_sample_count;
+    ms_ppm_slicer<0> *d_slicer;  // Bit slicer, the build for any rate (MS_RATE_RUNTIME)
+    ms_sample_clock *d_clock; // Time of the frames
+    pmt::pmt_t d_data_ref_key;      // Tag key for the reference at a data start
+    std::vector<gr_tag_t> d_tags;   // Data start references in the current work call
+    pmt::pmt_t d_rx_time_key;       // Tag key for the time of a sample
+    std::vector<gr_tag_t> d_time_tags;  // Sample times in the current work call
+
+    float data_reference(uint64_t offset);
 
 public:
+    ~air_ms_ppm_decode();
     void forecast (int noutput_items,
 		   gr_vector_int &ninput_items_required);
 
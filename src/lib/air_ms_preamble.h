@@ -23,9 +23,9 @@
 #define INCLUDED_AIR_MS_PREAMBLE_H
 
 #include <gr_sync_block.h>
-#include <air_ms_consts.h>   // For Mode S const values
 
 class air_ms_preamble;
+template <int RATE> class ms_preamble_detector;
 typedef boost::shared_ptr<air_ms_preamble> air_ms_preamble_sptr;
 
 air_ms_preamble_sptr air_make_ms_preamble(int channel_rate);
@@ -33,6 +33,9 @@ air_ms_preamble_sptr air_make_ms_preamble(int channel_rate);
 /*!
  * \brief mode select preamble detection
  * \ingroup block
+ *
+ * Input is the samples and attributes, output is the attributes only with the
+ * preamble starts marked.
  */
 class air_ms_preamble : public gr_sync_block
 {
@@ -42,14 +45,10 @@ private:
 
     float d_reference;   // current reference level
     int d_channel_rate;  // Sample rate of the streams
-    int d_bit_positions[MS_PREAMBLE_PULSE_COUNT];  // Position of preample pulses in samples
-    int d_data_start;        // When the data starts in samples
-    int d_check_width;   // Width of Preamble checking in samples
-    int d_chip_width;    // Width of chip (1/2 bit time) in samples
-    int d_bit_width;     // Width of bit in samples
-    int d_var_n;         // Number of samples to use after a leading edge
-    int d_var_m;         // d_var_n plus trailing edge
+    ms_preamble_detector<0> *d_detector;  // Shared preamble search, the build for any rate (MS_RATE_RUNTIME)
+    pmt::pmt_t d_ref_key;    // Tag key for the reference level
 public:
+    ~air_ms_preamble();
     int work (int noutput_items,
               gr_vector_const_void_star &input_items,
               gr_vector_void_star &output_items);
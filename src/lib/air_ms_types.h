@@ -23,16 +23,25 @@
 #define INCLUDED_AIR_MS_TYPES_H
 
 #include <time.h>            // For time_t
+#include <stdint.h>
 #include <air_ms_consts.h>   // For Mode S const values
 
+// Stream tag keys for the reference level.  The reference is only known at a
+// preamble start or data start so it travels beside the stream as a tag
+const char * const MS_TAG_PREAMBLE_REF = "ms_preamble_ref";
+const char * const MS_TAG_DATA_REF = "ms_data_ref";
+// Stream tag from a UHD source with the time of a sample
+const char * const MS_TAG_RX_TIME = "rx_time";
+
 /*!
  * \brief pipeline info that flows besides the data
  *
- * Not all modules need all the info
+ * Not all modules need all the info.  One byte per sample, the reference
+ * level is carried by the MS_TAG_PREAMBLE_REF and MS_TAG_DATA_REF tags.
  */
 class ms_plinfo {
 public:
-  ms_plinfo () : _flags (0), _reference (0.0) { }
+  ms_plinfo () : _flags (0) { }
 
   // accessors
 
@@ -42,7 +51,6 @@ public:
   bool data_start () const { return (_flags & fl_data_start) != 0; }
   bool data_end () const { return (_flags & fl_data_end) != 0; }
 
-  float reference ()	const { return _reference; }
   unsigned int flags () const { return _flags; }
 
   // setters
@@ -57,19 +65,13 @@ public:
     _flags |= fl_leading_edge;
   }
 
-  void set_reference (float reference)
-  {
-    _reference = reference;
-  }
-  void set_preamble_start (float reference)
+  void set_preamble_start ()
   {
-    _reference = reference;
     _flags |= fl_preamble_start;
   }
 
-  void set_data_start (float reference)
+  void set_data_start ()
   {
-    _reference = reference;
     _flags |= fl_data_start;
   }
   void set_data_end ()
@@ -81,28 +83,26 @@ public:
 
   void reset_all ()
   {
-    _reference = 0.0;
     _flags = 0;
   }
   void reset_preamble_start ()
   {
-    _reference = 0.0;
     _flags &= ~fl_preamble_start;
   }
   // overload equality operator
   bool operator== (const ms_plinfo &other) const {
-    return (_flags == other._flags && _reference == other._reference);
+    return (_flags == other._flags);
   }
 
   bool operator!= (const ms_plinfo &other) const {
-    return !(_flags == other._flags && _reference == other._reference);
+    return !(_flags == other._flags);
   }
 
 
 protected:
-  unsigned short	_flags;		// bitmask
-  float			_reference;	// reference level
+  unsigned char		_flags;		// bitmask
 
+public:
   //     This value is above the threshold
   static const int	fl_valid_pulse		= 0x0001;
   //	 This marks the leading edge of a pulse
@@ -118,36 +118,53 @@ protected:
 /*!
  * \brief Raw mode select data frame
  *
- *
+ * The bits are packed most significant bit first in 14 bytes.  The low
+ * confidence bits and the low energy bits are kept as two masks in the same
+ * layout, a low energy bit is also a low confidence bit.  The counts and
+ * positions of the low confidence bits are worked out from the masks up to
+ * the frame length.  The timestamp is the 64 bit sample number of the data
+ * start and rx_time is the time of that sample in nanoseconds, see
+ * ms_sample_clock.  The arrival time can be refined to a fraction of a sample,
+ * see ms_toa_estimator.  72 bytes per frame.
  */
 class ms_frame_raw {
 public:
-  ms_frame_raw () : _timestamp (0), _length(0),  _lcb_count(0), _first_lcb(-1), _last_lcb(-1),
-                    _leb_count(0), _first_leb(-1), _last_leb(-1) { }
+  ms_frame_raw () { reset_all(); }
 
   // accessors
 
-  bool bit_high_confidence (int index) const { return _flags[index] == 0; }
-  bool bit_low_confidence (int index) const { return (_flags[index] & fl_low_confidence) != 0; }
-  bool bit_low_energy (int index) const { return (_flags[index] & fl_low_energy) == fl_low_energy; }
-  unsigned char bit (int index)	const { return _bits[index]; }
-  unsigned int flags (int index) const { return _flags[index]; }
-  int timestamp () const { return _timestamp; }
+  bool bit_high_confidence (int index) const { return !get(_lcb, index); }
+  bool bit_low_confidence (int index) const { return get(_lcb, index); }
+  bool bit_low_energy (int index) const { return get(_leb, index); }
+  unsigned char bit (int index)	const { return get(_bits, index); }
+  unsigned int flags (int index) const
+  {
+    return get(_leb, index) ? fl_low_energy : (get(_lcb, index) ? fl_low_confidence : fl_high_confidence);
+  }
+  const unsigned char *bits () const { return _bits; }  // MS_FRAME_BYTES packed bits
+  const unsigned char *lcbs () const { return _lcb; }  // MS_FRAME_BYTES packed low confidence bits
+  uint64_t timestamp () const { return _timestamp; }
   float reference ()	const { return _reference; }
   int length() const { return _length; }
-  short lcb_count() const { return _lcb_count; }
-  short first_lcb() const { return _first_lcb; }
-  short last_lcb() const { return _last_lcb; }
-  short leb_count() const { return _leb_count; }
-  short first_leb() const { return _first_leb; }
-  short last_leb() const { return _last_leb; }
+  short lcb_count() const { return count(_lcb); }
+  short first_lcb() const { return first(_lcb); }
+  short last_lcb() const { return last(_lcb); }
+  short leb_count() const { return count(_leb); }
+  short first_leb() const { return first(_leb); }
+  short last_leb() const { return last(_leb); }
   unsigned short ec_quality() const { return _ec_quality; }
-  time_t rx_time() const { return _rx_time; }
+  time_t rx_time() const { return _rx_time / 1000000000ULL; }  // Seconds
+  uint64_t rx_time_ns() const { return _rx_time; }
+  bool toa_valid() const { return _toa != toa_none; }
+  // Sample number of the data start to a fraction of a sample, the timestamp if not refined
+  double toa() const { return (double)_timestamp + (toa_valid() ? _toa / (double)toa_scale : 0.0); }
+  // Arrival of the data start relative to the timestamp in samples, zero if not refined
+  float toa_offset() const { return toa_valid() ? _toa / (float)toa_scale : 0.0f; }
   unsigned int address() const { return _address; }
 
   // setters
 
-  void set_timestamp(int timestamp)
+  void set_timestamp(uint64_t timestamp)
   {
 	_timestamp = timestamp;
   }
@@ -171,57 +188,34 @@ public:
   {
     if(index < 0 || index >= MS_LONG_FRAME_LENGTH)
 	return;
-    _bits[index] = bit;
-    _flags[index] = fl_high_confidence;
+    put(_bits, index, bit);
+    put(_lcb, index, 0);
+    put(_leb, index, 0);
   }
 
   void set_bit_low_confidence (int index, unsigned char bit)
   {
     if(index < 0 || index >= MS_LONG_FRAME_LENGTH)
 	return;
-    _bits[index] = bit;
-    _flags[index] = fl_low_confidence;
+    put(_bits, index, bit);
+    put(_lcb, index, 1);
+    put(_leb, index, 0);
   }
 
   void set_bit_low_energy (int index, unsigned char bit)
   {
     if(index < 0 || index >= MS_LONG_FRAME_LENGTH)
 	return;
-    _bits[index] = bit;
-    _flags[index] = fl_low_energy;
+    put(_bits, index, bit);
+    put(_lcb, index, 1);
+    put(_leb, index, 1);
   }
 
   void set_bit_flipped (int index)
   {
     if(index < 0 || index >= MS_LONG_FRAME_LENGTH)
 	return;
-    _bits[index] = (_bits[index])?0:1;
-  }
-
-  void count_lcbs ()
-  {
-    reset_lcb();
-    for (int i = 0; i < _length; i++)
-    {
-    	if(_flags[i] == fl_low_confidence)
-    	{
-    		if(_first_lcb < 0)
-			_first_lcb = i;
-   		_last_lcb = i;
-    		_lcb_count++;
-    	}
-    	else if(_flags[i] == fl_low_energy)
-	{
-    		if(_first_lcb < 0)
-			_first_lcb = i;
-   		_last_lcb = i;
-    		_lcb_count++;
-    		if(_first_leb < 0)
-			_first_leb = i;
-    		_last_leb = i;
-    		_leb_count++;
-	}
-    }
+    _bits[index >> 3] ^= 0x80 >> (index & 7);
   }
 
   void set_ec_quality(int ec_quality)
@@ -230,10 +224,22 @@ public:
   }
 
   void set_rx_time(time_t rx_time)
+  {
+	_rx_time = (uint64_t)rx_time * 1000000000ULL;
+  }
+
+  void set_rx_time_ns(uint64_t rx_time)
   {
 	_rx_time = rx_time;
   }
 
+  // Arrival of the data start relative to the timestamp in samples
+  void set_toa(float offset)
+  {
+	float t = offset * toa_scale;
+	_toa = (t > 32767.0) ? 32767 : ((t < -32767.0) ? -32767 : (short)(t + ((t < 0) ? -0.5 : 0.5)));
+  }
+
   void set_address(int address)
   {
 	_address = address;
@@ -241,48 +247,97 @@ public:
 
  // resetters
 
-  void reset_lcb()
-  {
-    _lcb_count = 0;
-    _first_lcb = -1;
-    _last_lcb = -1;
-    _leb_count = 0;
-    _first_leb = -1;
-    _last_leb = -1;
-  }
-
   void reset_all ()
   {
     _timestamp = 0;
     _reference = 0.0;
-    _length = 0;
-    _lcb_count = 0;
-    _first_lcb = -1;
-    _last_lcb = -1;
-    _leb_count = 0;
-    _first_leb = -1;
-    _last_leb = -1;
+    _rx_time = 0;
+    _address = 0;
     _ec_quality = ec_unknown;
+    _toa = toa_none;
+    _length = 0;
+    for (int i = 0; i < MS_FRAME_BYTES; i++)
+    {
+	_bits[i] = 0;
+	_lcb[i] = 0;
+	_leb[i] = 0;
+    }
   }
 protected:
-  	static const int NPAD = 134;
-	int _timestamp;  // Timestamp in number of samples since start
+  	static const int NPAD = 1;
+	static const int toa_scale = 1024;    // _toa units per sample
+	static const short toa_none = -32768;  // _toa not measured
+	uint64_t _timestamp;  // Timestamp in number of samples since start
+	uint64_t _rx_time;    // Time of the timestamp sample in nanoseconds
 	float _reference; // "Signal Strength"
-	int _length;     // Length
-        unsigned char _bits[MS_LONG_FRAME_LENGTH];  // The bits of the frame
-	unsigned short _flags[MS_LONG_FRAME_LENGTH];  // The quality flags
-	short _lcb_count;  // count of low confidence bits
-	short _first_lcb;  // first low confidence bits
-	short _last_lcb;  // first low confidence bits
-	short _leb_count;  // count of low energy bits
-	short _first_leb;  // first low energy bits
-	short _last_leb;  // last low energy bits
-	unsigned short _ec_quality;  // The quality of this
-        time_t _rx_time;
-	unsigned char  _frame_type;  // 1st 5 bits
 	unsigned int   _address;   // airframe or interrogator address
+	unsigned short _ec_quality;  // The quality of this
+	short _toa;                  // Data start arrival - timestamp in 1/toa_scale samples
+	unsigned char _length;     // Length
+	unsigned char _bits[MS_FRAME_BYTES];  // The bits of the frame
+	unsigned char _lcb[MS_FRAME_BYTES];   // Low confidence bits
+	unsigned char _leb[MS_FRAME_BYTES];   // Low energy bits
 	unsigned char _pad_[NPAD];
 
+  static bool get(const unsigned char *m, int index)
+  {
+    return (m[index >> 3] >> (7 - (index & 7))) & 1;
+  }
+
+  static void put(unsigned char *m, int index, int value)
+  {
+    unsigned char b = 0x80 >> (index & 7);
+    m[index >> 3] = value ? (m[index >> 3] | b) : (m[index >> 3] & ~b);
+  }
+
+  // Bits 0 to 63 and 64 to 111 of a mask up to the frame length, bit 0 in the msb
+  void words(const unsigned char *m, uint64_t &w0, uint64_t &w1) const
+  {
+    w0 = 0;
+    w1 = 0;
+    for (int i = 0; i < 8; i++)
+	w0 = (w0 << 8) | m[i];
+    for (int i = 8; i < MS_FRAME_BYTES; i++)
+	w1 = (w1 << 8) | m[i];
+    w1 <<= 8 * (16 - MS_FRAME_BYTES);
+    if(_length <= 64)
+    {
+	w0 &= _length ? ~0ULL << (64 - _length) : 0;
+	w1 = 0;
+    }
+    else
+	w1 &= ~0ULL << (128 - _length);
+  }
+
+  short count(const unsigned char *m) const
+  {
+    uint64_t w0, w1;
+    words(m, w0, w1);
+    return __builtin_popcountll(w0) + __builtin_popcountll(w1);
+  }
+
+  short first(const unsigned char *m) const
+  {
+    uint64_t w0, w1;
+    words(m, w0, w1);
+    if(w0)
+	return __builtin_clzll(w0);
+    if(w1)
+	return 64 + __builtin_clzll(w1);
+    return -1;
+  }
+
+  short last(const unsigned char *m) const
+  {
+    uint64_t w0, w1;
+    words(m, w0, w1);
+    if(w1)
+	return 127 - __builtin_ctzll(w1);
+    if(w0)
+	return 63 - __builtin_ctzll(w0);
+    return -1;
+  }
+
 public:
   //     This bit is of high confidence
   static const int	fl_high_confidence	= 0x0000;
@@ -296,8 +351,11 @@ public:
   static const int	crc_bad			= 0x8000;  // totally NG
   static const int	eq_too_short_frame	= 0x4000;  // Frame too short
   static const int	eq_crc_overlayed	= 0x2000;  // CRC has data overlay and low confidence bits present
+  static const int	eq_ec_deferred		= 0x1000;  // EC not done, over the time budget
   static const int	eq_ec_na		= 0x0800;  // EC can not be done
   static const int	eq_ec_multiple		= 0x0400;  // EC can not be done (Multiple solutions
+  static const int	eq_ap_cached		= 0x0010;  // Address overlaid on the parity is in the address cache
+  static const int	eq_ec_table		= 0x0008;  // EC was done from the one and two bit syndrome table
   static const int	eq_ec_corrected		= 0x0004;  // EC was done
   static const int	eq_change_short_frame	= 0x0002;  // Long frame is really short
   static const int	crc_ok			= 0x0001;  // Everything ok
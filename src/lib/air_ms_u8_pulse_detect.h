@@ -0,0 +1,61 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIR_MS_U8_PULSE_DETECT_H
+#define INCLUDED_AIR_MS_U8_PULSE_DETECT_H
+
+#include <gr_sync_block.h>
+#include <vector>
+
+class air_ms_u8_pulse_detect;
+typedef boost::shared_ptr<air_ms_u8_pulse_detect> air_ms_u8_pulse_detect_sptr;
+
+air_ms_u8_pulse_detect_sptr air_make_ms_u8_pulse_detect(float alpha, float beta, int width);
+
+/*!
+ * \brief mode select magnitude and pulse detect of unsigned 8 bit IQ
+ * \ingroup block
+ *
+ * Takes interleaved unsigned 8 bit IQ pairs, two bytes an item with 127.5 as
+ * zero, as the low cost receivers give them, and does the work of
+ * ms_mag_pulse_detect without converting them to complex.  The magnitude of
+ * each pair is looked up in a table and is in the units of the samples, so
+ * the threshold beta is too, 0 to 180.  With only the magnitude output
+ * connected the pulses are not detected.
+ */
+class air_ms_u8_pulse_detect : public gr_sync_block
+{
+private:
+    friend air_ms_u8_pulse_detect_sptr air_make_ms_u8_pulse_detect(float alpha, float beta, int width);
+    air_ms_u8_pulse_detect(float alpha, float beta, int width);
+
+    float d_alpha;      // Attack constant used to test if pulse edge
+    float d_beta;       // Threshold in sample units
+    int d_width;        // width of valid pulse in samples minus 2 for edges
+    std::vector<unsigned int> d_over;  // Bitmap of samples at or above threshold
+
+public:
+    int work (int noutput_items,
+              gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items);
+};
+
+#endif /* INCLUDED_AIR_MS_U8_PULSE_DETECT_H */
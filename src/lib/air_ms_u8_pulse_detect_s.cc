@@ -0,0 +1,68 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>              // for pow()
+#include <gr_io_signature.h>
+#include <air_ms_types.h>
+#include <air_ms_u8_pulse_detect_s.h>
+#include <airi_ms_mag.h>
+
+air_ms_u8_pulse_detect_s_sptr air_make_ms_u8_pulse_detect_s(float alpha, float beta, int width)
+{
+    return air_ms_u8_pulse_detect_s_sptr(new air_ms_u8_pulse_detect_s(alpha, beta, width));
+}
+
+air_ms_u8_pulse_detect_s::air_ms_u8_pulse_detect_s(float alpha, float beta, int width) :
+    gr_sync_block ("ms_u8_pulse_detect_s",
+                   gr_make_io_signature (1, 1, 2 * sizeof(unsigned char)),
+                   gr_make_io_signature2 (2, 2, sizeof(unsigned short), sizeof(ms_plinfo)))
+{
+    d_alpha = powf(10., alpha/20.);  // Convert leading edge threshold from db to ratio
+    d_beta = (unsigned int)ceilf(beta * MS_U8_MAG_SCALE);  // Threshold of valid pulse
+    d_width = width;                 // width of valid pulse - 1
+    set_history(2);	// need to look at two inputs
+    set_output_multiple(1+d_width); // Look ahead for a valid pulse width
+}
+
+int air_ms_u8_pulse_detect_s::work(int noutput_items,
+                          gr_vector_const_void_star &input_items,
+		                  gr_vector_void_star &output_items)
+{
+    const unsigned char *in = (const unsigned char *) input_items[0];
+    unsigned short *data_out = (unsigned short *) output_items[0];  // magnitude out
+    ms_plinfo   *attrib_out = (ms_plinfo *) output_items[1];    // attribute data out
+    int nwords = (noutput_items + 31) / 32;
+    // Magnitude of the sample before the first output for the leading edge test
+    unsigned short first;
+    unsigned int first_over;
+    ms_mag_detect_u8(in, &first, &first_over, d_beta, 1);
+    in += 2;
+
+    if((int)d_over.size() < nwords)
+	d_over.resize(nwords);
+    ms_mag_detect_u8(in, data_out, &d_over[0], d_beta, noutput_items);
+    ms_pulse_attributes(data_out, first, &d_over[0], attrib_out, ms_make_db_ratio(d_alpha), d_width, noutput_items);
+    return noutput_items-d_width;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <airi_ms_address.h>
+#include <air_ms_types.h>
+
+// Slots in the shared cache, well over the aircraft in range of a receiver
+const int MS_ADDRESS_SLOTS = 8192;
+// Seconds an address stays in the cache after it was last seen
+const int MS_ADDRESS_MAX_AGE = 60;
+// Longest probe sequence, an insert into a full stretch is dropped
+const int MS_ADDRESS_MAX_PROBES = 32;
+
+int ms_downlink_format(const ms_frame_raw &frame)
+{
+    return frame.bits()[0] >> 3;
+}
+
+bool ms_address_parity_format(int df)
+{
+    return (df == 0) || (df == 4) || (df == 5) || (df == 16) || (df == 20) || (df == 21);
+}
+
+unsigned int ms_announced_address(const ms_frame_raw &frame)
+{
+    const unsigned char *bits = frame.bits();
+    int df = bits[0] >> 3;
+    // DF18 carries an ICAO address only with CF 0
+    if((df == 11) || (df == 17) || ((df == 18) && ((bits[0] & 7) == 0)))
+	return (bits[1] << 16) | (bits[2] << 8) | bits[3];
+    return 0;
+}
+
+ms_address_cache::ms_address_cache(int slots, int max_age) :
+    d_max_age(max_age),
+    d_lookups(0),
+    d_hits(0),
+    d_probes(0),
+    d_inserts(0)
+{
+    int bits = 1;
+    while((1 << bits) < slots)
+	bits++;
+    d_shift = 32 - bits;
+    d_entries.assign(1 << bits, 0);
+}
+
+void ms_address_cache::insert(unsigned int address, unsigned int now)
+{
+    unsigned int mask = d_entries.size() - 1;
+    uint64_t entry = ((uint64_t)address << 32) | now;
+    unsigned int s = slot(address);
+    if(!address)
+	return;
+    __sync_fetch_and_add(&d_inserts, 1);
+    for(int k = 0; k < MS_ADDRESS_MAX_PROBES; )
+    {
+	volatile uint64_t *p = &d_entries[s];
+	uint64_t old = *p;
+	// An empty entry, this address or an expired one is taken over
+	if(!old || ((old >> 32) == address) || expired(old, now))
+	{
+		if(__sync_bool_compare_and_swap(p, old, entry))
+			return;
+		continue;  // Lost a race for the entry so look at it again
+	}
+	s = (s + 1) & mask;
+	k++;
+    }
+}
+
+bool ms_address_cache::contains(unsigned int address, unsigned int now)
+{
+    unsigned int mask = d_entries.size() - 1;
+    unsigned int s = slot(address);
+    int reads = 0;
+    bool found = false;
+    while(reads < MS_ADDRESS_MAX_PROBES)
+    {
+	uint64_t entry = *(volatile uint64_t *)&d_entries[s];
+	reads++;
+	if(!entry)
+		break;
+	if(((entry >> 32) == address) && !expired(entry, now))
+	{
+		found = true;
+		break;
+	}
+	s = (s + 1) & mask;
+    }
+    __sync_fetch_and_add(&d_lookups, 1);
+    __sync_fetch_and_add(&d_probes, reads);
+    if(found)
+	__sync_fetch_and_add(&d_hits, 1);
+    return found;
+}
+
+ms_address_cache &ms_address_cache::shared()
+{
+    static ms_address_cache cache(MS_ADDRESS_SLOTS, MS_ADDRESS_MAX_AGE);
+    return cache;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_ADDRESS_H
+#define INCLUDED_AIRI_MS_ADDRESS_H
+
+#include <vector>
+#include <stdint.h>
+
+class ms_frame_raw;
+
+// Downlink format of a frame
+int ms_downlink_format(const ms_frame_raw &frame);
+// Formats with the address overlaid on the parity (DF0/4/5/16/20/21)
+bool ms_address_parity_format(int df);
+// Address announced by a frame with zero syndrome (DF11, DF17, DF18 with
+// an ICAO address), zero if it has none
+unsigned int ms_announced_address(const ms_frame_raw &frame);
+
+/*
+ * Cache of the ICAO addresses recently seen in frames with good parity
+ *
+ * The cache is an open addressed hash of 64 bit words, the address in the
+ * high half and the rx_time it was last seen in the low half.  Entries are
+ * updated with compare and swap so any number of threads can use the cache.
+ * An address not seen for max_age seconds is treated as gone and its entry
+ * can be taken by another address.
+ */
+class ms_address_cache
+{
+public:
+    ms_address_cache(int slots, int max_age);
+
+    // Record an address as seen at time now
+    void insert(unsigned int address, unsigned int now);
+    // True if the address was seen within max_age of now
+    bool contains(unsigned int address, unsigned int now);
+
+    // Counters
+    unsigned long lookups() const { return d_lookups; }
+    unsigned long hits() const { return d_hits; }
+    unsigned long probes() const { return d_probes; }    // Entries read by lookups
+    unsigned long inserts() const { return d_inserts; }
+
+    // The cache shared by the blocks
+    static ms_address_cache &shared();
+
+private:
+    bool expired(uint64_t entry, unsigned int now) const
+    {
+	return (int)(now - (unsigned int)entry) > d_max_age;
+    }
+    unsigned int slot(unsigned int address) const
+    {
+	return (address * 0x9e3779b1u) >> d_shift;
+    }
+
+    std::vector<uint64_t> d_entries;
+    int d_shift;
+    int d_max_age;
+    unsigned long d_lookups;
+    unsigned long d_hits;
+    unsigned long d_probes;
+    unsigned long d_inserts;
+};
+
+#endif /* INCLUDED_AIRI_MS_ADDRESS_H */
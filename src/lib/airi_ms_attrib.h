@@ -0,0 +1,58 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_ATTRIB_H
+#define INCLUDED_AIRI_MS_ATTRIB_H
+
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <air_ms_types.h>
+
+/*
+ * Append the positions in [start, end) that have a leading edge to edges.
+ * ms_plinfo is one byte so eight samples are tested with each load and
+ * the quiet stretches between replies cost very little.
+ */
+inline void ms_find_leading_edges(const ms_plinfo *attrib, int start, int end, std::vector<int> &edges)
+{
+	const uint64_t mask = 0x0101010101010101ULL * ms_plinfo::fl_leading_edge;
+	int i = start;
+	for( ; i + 8 <= end; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, attrib + i, sizeof(word));
+		if((word & mask) == 0)
+			continue;
+		for(int k = i; k < i + 8; k++)
+		{
+			if(attrib[k].leading_edge())
+				edges.push_back(k);
+		}
+	}
+	for( ; i < end; i++)
+	{
+		if(attrib[i].leading_edge())
+			edges.push_back(i);
+	}
+}
+
+#endif /* INCLUDED_AIRI_MS_ATTRIB_H */
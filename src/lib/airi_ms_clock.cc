@@ -0,0 +1,93 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/time.h>
+#include <gruel/pmt.h>
+#include <airi_ms_clock.h>
+#include <air_ms_types.h>
+
+const uint64_t MS_NS_PER_SECOND = 1000000000ULL;
+
+ms_sample_clock::ms_sample_clock(int channel_rate) :
+    d_channel_rate(channel_rate),
+    d_anchored(false),
+    d_tagged(false),
+    d_tag_offset(0),
+    d_anchors(0)
+{
+    d_anchor.sample = 0;
+    d_anchor.ns = 0;
+}
+
+void ms_sample_clock::add_tags(const std::vector<gr_tag_t> &tags)
+{
+    for (size_t i = 0; i < tags.size(); i++)
+    {
+	const gr_tag_t &tag = tags[i];
+	if(d_tagged && (tag.offset <= d_tag_offset))
+		continue;
+	// UHD sends the whole seconds and the fractional seconds
+	if(!pmt::pmt_is_tuple(tag.value) || (pmt::pmt_length(tag.value) != 2))
+		continue;
+	anchor a;
+	a.sample = tag.offset;
+	a.ns = pmt::pmt_to_uint64(pmt::pmt_tuple_ref(tag.value, 0)) * MS_NS_PER_SECOND
+	       + (uint64_t)(pmt::pmt_to_double(pmt::pmt_tuple_ref(tag.value, 1)) * 1e9 + 0.5);
+	d_pending.push_back(a);
+	d_tagged = true;
+	d_tag_offset = tag.offset;
+    }
+}
+
+uint64_t ms_sample_clock::time_ns(uint64_t sample)
+{
+    while(!d_pending.empty() && (d_pending.front().sample <= sample))
+    {
+	d_anchor = d_pending.front();
+	d_pending.pop_front();
+	d_anchored = true;
+	d_anchors++;
+    }
+    if(!d_anchored)
+    {
+	struct timeval now;
+	gettimeofday(&now, 0);
+	d_anchor.sample = sample;
+	d_anchor.ns = (uint64_t)now.tv_sec * MS_NS_PER_SECOND + (uint64_t)now.tv_usec * 1000;
+	d_anchored = true;
+	d_anchors++;
+    }
+    if(sample >= d_anchor.sample)
+	return d_anchor.ns + offset_ns(sample - d_anchor.sample);
+    return d_anchor.ns - offset_ns(d_anchor.sample - sample);
+}
+
+// Whole seconds and the remainder apart so the product can not overflow
+uint64_t ms_sample_clock::offset_ns(uint64_t samples) const
+{
+    uint64_t seconds = samples / d_channel_rate;
+    uint64_t rest = samples % d_channel_rate;
+    return seconds * MS_NS_PER_SECOND + rest * MS_NS_PER_SECOND / d_channel_rate;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_CLOCK_H
+#define INCLUDED_AIRI_MS_CLOCK_H
+
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include <gr_tags.h>
+
+/*
+ * Time of a sample from the sample count
+ *
+ * The time of a sample is worked out from an anchor, a sample whose time is
+ * known, and the channel rate.  A UHD source tags the first sample of a
+ * stream, and the first after an overflow, with rx_time and those tags are
+ * the anchors.  Without an rx_time tag the first sample asked about is
+ * anchored to the system clock once and the sample count carries on from it.
+ */
+class ms_sample_clock
+{
+public:
+    ms_sample_clock(int channel_rate);
+
+    // Take the rx_time tags from a work call.  A block sees the same input
+    // again when it does not consume it all so tags up to the latest taken
+    // are skipped.
+    void add_tags(const std::vector<gr_tag_t> &tags);
+    // Nanoseconds since the epoch of a sample.  Samples are asked about in
+    // order, an anchor is used once the samples reach it.
+    uint64_t time_ns(uint64_t sample);
+
+    unsigned long anchors() const { return d_anchors; }  // Anchors used
+
+private:
+    struct anchor
+    {
+	uint64_t sample;
+	uint64_t ns;
+    };
+    uint64_t offset_ns(uint64_t samples) const;
+
+    int d_channel_rate;
+    std::deque<anchor> d_pending;  // Tagged anchors the samples have not reached
+    anchor d_anchor;               // Anchor in use
+    bool d_anchored;
+    bool d_tagged;                 // d_tag_offset is valid
+    uint64_t d_tag_offset;         // Offset of the latest tag taken
+    unsigned long d_anchors;
+};
+
+#endif /* INCLUDED_AIRI_MS_CLOCK_H */
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <air_ms_types.h>
+#include <airi_ms_demod.h>
+#include <airi_ms_preamble.h>
+#include <airi_ms_framer.h>
+#include <airi_ms_ppm.h>
+#include <airi_ms_clock.h>
+#include <airi_ms_toa.h>
+#include <airi_ms_parity.h>
+
+ms_demod_kernel::ms_demod_kernel(int channel_rate, bool toa, float scale)
+{
+    d_clock = new ms_sample_clock(channel_rate);
+    d_toa = toa ? new ms_toa_estimator(channel_rate) : 0;
+    d_toa_frames = 0;
+    d_scale = scale;
+    d_max_frame_width = 0;
+    d_lookahead = 0;
+}
+
+ms_demod_kernel::~ms_demod_kernel()
+{
+    delete d_clock;
+    delete d_toa;
+}
+
+// The kernel built for a channel rate
+template <int RATE>
+class ms_demod_kernel_rate : public ms_demod_kernel
+{
+public:
+    ms_demod_kernel_rate(int channel_rate, bool toa, float scale) :
+	ms_demod_kernel(channel_rate, toa, scale),
+	d_rate(channel_rate),
+	d_detector(channel_rate),
+	d_framer(channel_rate),
+	d_slicer(channel_rate)
+    {
+	d_max_frame_width = d_rate.max_frame_width;
+	// A frame and the retrigger checks on its last sample
+	d_lookahead = d_max_frame_width + 2 + d_detector.check_width();
+    }
+
+    int demod(const float *data_in, const ms_plinfo *attrib_in, int ninput, uint64_t nread,
+              ms_frame_raw *data_out, int noutput, int &consumed)
+    {
+	return demod_samples(data_in, attrib_in, ninput, nread, data_out, noutput, consumed);
+    }
+    int demod(const unsigned short *data_in, const ms_plinfo *attrib_in, int ninput, uint64_t nread,
+              ms_frame_raw *data_out, int noutput, int &consumed)
+    {
+	return demod_samples(data_in, attrib_in, ninput, nread, data_out, noutput, consumed);
+    }
+
+    unsigned long format_frames() const { return d_framer.format_frames(); }
+    unsigned long pulse_frames() const { return d_framer.pulse_frames(); }
+    unsigned long rejected_frames() const { return d_framer.rejected_frames(); }
+
+private:
+    template <typename T>
+    int demod_samples(const T *data_in, const ms_plinfo *attrib_in, int ninput, uint64_t nread,
+                      ms_frame_raw *data_out, int noutput, int &consumed);
+
+    ms_rate<RATE> d_rate;                 // Sample positions and widths
+    ms_preamble_detector<RATE> d_detector;  // Preamble search
+    ms_framer_kernel<RATE> d_framer;        // Frame length
+    ms_ppm_slicer<RATE> d_slicer;           // Bit slicer
+};
+
+template <int RATE>
+template <typename T>
+int ms_demod_kernel_rate<RATE>::demod_samples(const T *data_in, const ms_plinfo *attrib_in, int ninput,
+                                              uint64_t nread, ms_frame_raw *data_out, int noutput, int &consumed)
+{
+    typedef ms_sample_traits<T> traits;
+    int size = ninput - d_lookahead; // Only search up to a frame from the end
+    int i, j, k;
+    int out_count = 0;
+    int frame_size;
+    int bit_index;
+    int frame_end;
+    typename traits::level reference;
+    typename traits::level later;
+    typename traits::level high_limit;
+    if(size <= 0)
+    {
+	consumed = 0;
+	return 0;
+    }
+    // The retrigger checks look at preamble starts up to a frame past size
+    d_detector.scan(attrib_in, size + d_max_frame_width + 2);
+    // Like ms_framer the search continues after the sample after the frame or at the stronger preamble
+    for (i = 0; (i < size) && (out_count < noutput); i = i + j + 1)
+    {
+	i = d_detector.find(data_in, attrib_in, i, size, reference);
+	if(i >= size)
+		break;
+	frame_size = d_framer.frame_width(data_in, attrib_in, i, reference);
+	if(frame_size == 0)
+	{
+		j = 0;  // Not a valid downlink format so look again from the next sample
+		continue;
+	}
+        // "Retrigger"  See if there is a preamble detected with a level that is more than 3 dB
+        //              in the frame.  If so ignore current frame and move on
+	high_limit = traits::upper_limit(reference, ms_db_plus_3);  // + 3 dB
+	for (j = frame_size + 1, k = d_detector.find(data_in, attrib_in, i + 1, i + frame_size + 1, later);
+	     k <= i + frame_size;
+	     k = d_detector.find(data_in, attrib_in, k + 1, i + frame_size + 1, later))
+	{
+		if (high_limit < later)
+		{
+			j = k - i - 1;  // Ignore current preamble and any preamble up to the stronger one
+			break;
+		}
+	}
+        // If no stronger preamble in the frame then decode it
+	if(j > frame_size)
+	{
+		ms_frame_raw &frame = data_out[out_count++];
+		frame.reset_all();
+		frame.set_timestamp(nread + i + d_rate.data_start);
+		frame.set_rx_time_ns(d_clock->time_ns(nread + i + d_rate.data_start));
+		frame.set_reference(traits::reference_level(reference) / d_scale);
+		d_slicer.slice(data_in, attrib_in, i + d_rate.data_start, ninput, i + frame_size,
+		                reference, frame, bit_index, frame_end);
+		if(bit_index >= MS_LONG_FRAME_LENGTH)
+		{
+			frame.set_long_frame();
+		}
+		else if (bit_index >= MS_SHORT_FRAME_LENGTH)
+		{
+			frame.set_short_frame();
+		}
+		// Only the frames that pass the parity check are worth the arrival time
+		float offset;
+		if(d_toa && frame.length() && (ms_check_parity(frame) == 0) &&
+		   d_toa->estimate(data_in, i, traits::reference_level(reference), offset))
+		{
+			frame.set_toa(offset);
+			d_toa_frames++;
+		}
+	}
+    }
+    consumed = i;
+    return out_count;
+}
+
+ms_demod_kernel *ms_make_demod_kernel(int channel_rate, bool toa, float scale)
+{
+    switch(channel_rate)
+    {
+    case 8000000:
+	return new ms_demod_kernel_rate<8000000>(channel_rate, toa, scale);
+    case 10000000:
+	return new ms_demod_kernel_rate<10000000>(channel_rate, toa, scale);
+    case 16000000:
+	return new ms_demod_kernel_rate<16000000>(channel_rate, toa, scale);
+    case 20000000:
+	return new ms_demod_kernel_rate<20000000>(channel_rate, toa, scale);
+    default:
+	return new ms_demod_kernel_rate<MS_RATE_RUNTIME>(channel_rate, toa, scale);
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_DEMOD_H
+#define INCLUDED_AIRI_MS_DEMOD_H
+
+#include <stdint.h>
+#include <airi_ms_sample.h>
+
+class ms_plinfo;
+class ms_frame_raw;
+class ms_sample_clock;
+class ms_toa_estimator;
+
+/*
+ * Mode S demodulation shared by the fused demodulator blocks
+ *
+ * Finds the preambles, takes the frame length from the downlink format, drops
+ * frames a stronger preamble retriggers and slices the rest, in one pass over
+ * the samples.  The samples are float or unsigned short, see airi_ms_sample.h.
+ * Frames are given the reference level divided by scale, the units of the
+ * samples per unit of the input.  ms_make_demod_kernel() picks the build for
+ * the channel rate, see airi_ms_rate.h.
+ */
+class ms_demod_kernel
+{
+public:
+    virtual ~ms_demod_kernel();
+
+    // Up to noutput frames from the ninput samples and attributes from sample
+    // nread.  Preambles are looked for up to lookahead() samples from the end
+    // and consumed is where the search stopped.  Returns the number of frames.
+    virtual int demod(const float *data_in, const ms_plinfo *attrib_in, int ninput, uint64_t nread,
+                      ms_frame_raw *data_out, int noutput, int &consumed) = 0;
+    virtual int demod(const unsigned short *data_in, const ms_plinfo *attrib_in, int ninput, uint64_t nread,
+                      ms_frame_raw *data_out, int noutput, int &consumed) = 0;
+
+    ms_sample_clock &clock() { return *d_clock; }
+    int lookahead() const { return d_lookahead; }
+    int max_frame_width() const { return d_max_frame_width; }
+
+    // Counters
+    virtual unsigned long format_frames() const = 0;
+    virtual unsigned long pulse_frames() const = 0;
+    virtual unsigned long rejected_frames() const = 0;
+    unsigned long toa_frames() const { return d_toa_frames; }
+
+protected:
+    ms_demod_kernel(int channel_rate, bool toa, float scale);
+
+    int d_max_frame_width;  // length of long frame in samples
+    int d_lookahead;     // Samples needed after the last preamble start searched
+    float d_scale;       // Sample units per input unit
+    ms_sample_clock *d_clock;          // Time of the frames
+    ms_toa_estimator *d_toa;           // Arrival time refinement, 0 if off
+    unsigned long d_toa_frames;
+
+private:
+    // Not copyable, the clock and estimator are owned
+    ms_demod_kernel(const ms_demod_kernel &);
+    ms_demod_kernel &operator=(const ms_demod_kernel &);
+};
+
+ms_demod_kernel *ms_make_demod_kernel(int channel_rate, bool toa, float scale = 1.0);
+
+#endif /* INCLUDED_AIRI_MS_DEMOD_H */
@@ -0,0 +1,340 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <airi_ms_ec.h>
+#include <airi_ms_parity.h>
+#include <airi_ms_syndrome.h>
+#include <airi_ms_address.h>
+#include <airi_ms_ec_memo.h>
+#include <air_ms_types.h>
+
+ms_ec_search::ms_ec_search() :
+    d_entries(1 << (MS_EC_MAX_LCBS / 2 + 1)),
+    d_epoch(0)
+{
+}
+
+int ms_ec_search::solve(const unsigned int *syndromes, int n, unsigned int target, unsigned int &correction)
+{
+    int low = n / 2;         // Syndromes in the first half
+    int high = n - low;      // and the second half
+    int bits = low + 1;      // At least twice as many slots as subsets
+    unsigned int mask = (1u << bits) - 1;
+    unsigned int step, s, k, syndrome, subset;
+    int found = 0;
+
+    // A new epoch empties the table
+    if(++d_epoch == 0)
+    {
+	for(k = 0; k < d_entries.size(); k++)
+		d_entries[k].epoch = 0;
+	d_epoch = 1;
+    }
+    // Hash every subset of the first half including the empty one
+    syndrome = 0;
+    subset = 0;
+    for(step = 0; step < (1u << low); step++)
+    {
+	if(step)
+	{
+		k = __builtin_ctz(step);
+		syndrome ^= syndromes[k];
+		subset ^= 1u << k;
+	}
+	for(s = (syndrome * 0x9e3779b1u) >> (32 - bits); ; s = (s + 1) & mask)
+	{
+		entry &e = d_entries[s];
+		if(e.epoch != d_epoch)
+		{
+			e.syndrome = syndrome;
+			e.subset = subset;
+			e.count = 1;
+			e.epoch = d_epoch;
+			break;
+		}
+		if(e.syndrome == syndrome)
+		{
+			e.subset = subset;
+			e.count++;
+			break;
+		}
+	}
+    }
+    // Match every subset of the second half against the first half
+    syndrome = target;
+    subset = 0;
+    for(step = 0; step < (1u << high); step++)
+    {
+	if(step)
+	{
+		k = __builtin_ctz(step);
+		syndrome ^= syndromes[low + k];
+		subset ^= 1u << k;
+	}
+	for(s = (syndrome * 0x9e3779b1u) >> (32 - bits); ; s = (s + 1) & mask)
+	{
+		const entry &e = d_entries[s];
+		if(e.epoch != d_epoch)
+			break;
+		if(e.syndrome == syndrome)
+		{
+			// The empty subset of both halves is not a solution
+			unsigned int count = e.count - ((step == 0) && (target == 0));
+			if(!found && count)
+				correction = e.subset | (subset << low);
+			found += count;
+			break;
+		}
+	}
+	if(found > 1)
+		return 2;
+    }
+    return found;
+}
+
+// Most low confidence bits for the address search, each subset is a chance
+// of a false match with one of the cached addresses
+const int MS_EC_ADDRESS_MAX_LCBS = 5;
+// Remembered outcomes and how long an unused one is kept in seconds
+const int MS_EC_MEMO_ENTRIES = 256;
+const int MS_EC_MEMO_MAX_AGE = 30;
+
+ms_ec_corrector::ms_ec_corrector(int max_lcbs, ms_address_cache *cache) :
+    d_max_lcbs(max_lcbs),
+    d_cache(cache),
+    d_table_corrections(0),
+    d_search_corrections(0),
+    d_address_corrections(0),
+    d_skipped(0)
+{
+    if(d_max_lcbs < 0)
+	d_max_lcbs = 0;
+    if(d_max_lcbs > MS_EC_MAX_LCBS)
+	d_max_lcbs = MS_EC_MAX_LCBS;
+    d_memo = new ms_ec_memo(MS_EC_MEMO_ENTRIES, MS_EC_MEMO_MAX_AGE);
+}
+
+ms_ec_corrector::~ms_ec_corrector()
+{
+    delete d_memo;
+}
+
+unsigned long ms_ec_corrector::memo_hits() const
+{
+    return d_memo->hits();
+}
+
+unsigned long ms_ec_corrector::memo_misses() const
+{
+    return d_memo->misses();
+}
+
+bool ms_ec_corrector::address_search_applies(const ms_frame_raw &frame) const
+{
+    return d_cache && (frame.lcb_count() <= MS_EC_ADDRESS_MAX_LCBS) && (frame.first_lcb() >= MS_DF_LENGTH) &&
+	ms_address_parity_format(ms_downlink_format(frame));
+}
+
+bool ms_ec_corrector::quick(ms_frame_raw &frame)
+{
+    if((frame.lcb_count() == 0) || (frame.ec_quality() & (ms_frame_raw::crc_ok | ms_frame_raw::eq_ec_corrected)))
+	return true;  // Nothing to do
+    if(frame.lcb_count() > d_max_lcbs)
+    {
+	frame.set_ec_quality(ms_frame_raw::eq_ec_na);  // Too many lcbs
+	d_skipped++;
+	return true;
+    }
+    return false;
+}
+
+void ms_ec_corrector::correct(ms_frame_raw &frame)
+{
+    unsigned char flips[MS_FRAME_BYTES];
+    unsigned short quality;
+    int j;
+
+    if(quick(frame))
+	return;
+    // The outcome of the address search depends on what is in the address cache
+    if(address_search_applies(frame))
+    {
+	solve(frame);
+	return;
+    }
+    // A repeat of a frame needs no search
+    if(d_memo->find(frame, flips, quality))
+    {
+	for(j = 0; j < frame.length(); j++)
+	{
+		if((flips[j >> 3] >> (7 - (j & 7))) & 1)
+			frame.set_bit_flipped(j);
+	}
+	if(quality & ms_frame_raw::eq_ec_corrected)
+		frame.set_address(ms_check_parity(frame));
+	frame.set_ec_quality(quality);
+	return;
+    }
+    ms_frame_raw before = frame;
+    solve(frame);
+    for(j = 0; j < MS_FRAME_BYTES; j++)
+	flips[j] = frame.bits()[j] ^ before.bits()[j];
+    d_memo->insert(before, flips, frame.ec_quality());
+}
+
+void ms_ec_corrector::solve(ms_frame_raw &frame)
+{
+    unsigned int error_syndrome = 0;
+    unsigned int crc;
+    int lcb_positions[MS_EC_MAX_LCBS];
+    unsigned int lcb_syndromes[MS_EC_MAX_LCBS];
+    int error_positions[2];
+    int nbits;
+    bool table;
+    int j, index;
+    int offset;
+    int found;
+    unsigned int correction = 0;
+
+    // The assumption is Mode A/C "Fruit" flipped some bits that were set as low confidence upstream.
+    // This will only work for ADS-B and ACAS/TCAS Frames as the address overlayed on the parity is zero.
+    // Get the error
+    error_syndrome = ms_check_parity(frame);
+    index = 0;
+    found = 0;
+    // Offset into the parity table for short frames  The offsets are 0 for long frames and 56 for short frames
+    offset = MS_LONG_FRAME_LENGTH - frame.length();
+    // Get the low confidence bits and their syndromes
+    for (j= frame.first_lcb(); j <= frame.last_lcb();j++)
+    {
+	if(frame.flags(j))
+	{
+		lcb_syndromes[index] = ms_parity_table[j+offset];
+		lcb_positions[index++] =j;
+	}
+    }
+    // With the address overlaid on the parity a solution leaves a cached address
+    if(address_search_applies(frame))
+    {
+	found = address_search(lcb_syndromes, index, error_syndrome, frame.rx_time(), correction);
+	if(found == 1)
+	{
+		for(j = 0; j < index; j++)
+		{
+			if((correction >> j) & 1)
+				frame.set_bit_flipped(lcb_positions[j]);
+		}
+		frame.set_address(ms_check_parity(frame));
+		if(correction)
+			frame.set_ec_quality(ms_frame_raw::eq_ec_corrected | ms_frame_raw::eq_ap_cached);
+		else
+			frame.set_ec_quality(ms_frame_raw::crc_ok | ms_frame_raw::eq_ap_cached);
+		d_address_corrections++;
+		return;
+	}
+	if(found > 1)
+	{
+		frame.set_ec_quality(ms_frame_raw::eq_ec_multiple);
+		return;
+	}
+    }
+    // Most errors are one or two bits so look them up first
+    table = false;
+    nbits = ms_syndromes(frame.length()).lookup(error_syndrome, error_positions);
+    if(nbits)
+    {
+	// Only a correction of low confidence bits is accepted
+	for(j = 0, correction = 0; j < index; j++)
+	{
+		if((lcb_positions[j] == error_positions[0]) || ((nbits == 2) && (lcb_positions[j] == error_positions[1])))
+			correction |= 1u << j;
+	}
+	if(__builtin_popcount(correction) == nbits)
+	{
+		// The search would find other solutions only if some low confidence bits cancel out
+		found = ms_syndromes_independent(lcb_syndromes, index) ? 1 : 2;
+		table = true;
+	}
+    }
+    // Otherwise search all the subsets of the low confidence bits
+    // If over one solution then it is no solution
+    if(!table)
+	found = d_search.solve(lcb_syndromes, index, error_syndrome, correction);
+    if(found == 1) // Only one valid solution
+    {
+	// Flip the bits
+	for(j = 0; j < index; j++)
+	{
+		if((correction >> j) & 1)
+		{
+			frame.set_bit_flipped(lcb_positions[j]);
+		}
+	}
+	// Correct the output
+	crc = ms_check_parity(frame);
+	frame.set_address(crc);
+	if(table)
+	{
+		frame.set_ec_quality(ms_frame_raw::eq_ec_corrected | ms_frame_raw::eq_ec_table);
+		d_table_corrections++;
+	}
+	else
+	{
+		frame.set_ec_quality(ms_frame_raw::eq_ec_corrected);
+		d_search_corrections++;
+	}
+    }
+    else if(found > 1)  // Indicate multiple solutions
+	frame.set_ec_quality(ms_frame_raw::eq_ec_multiple);
+    else  // Nothing can be done
+	frame.set_ec_quality(ms_frame_raw::eq_ec_na);
+}
+
+int ms_ec_corrector::address_search(const unsigned int *syndromes, int n, unsigned int target, unsigned int now, unsigned int &correction)
+{
+    unsigned int syndrome = target;
+    unsigned int subset = 0;
+    unsigned int step, k;
+    int found = 0;
+
+    // Every subset including the empty one in Gray code order
+    for(step = 0; step < (1u << n); step++)
+    {
+	if(step)
+	{
+		k = __builtin_ctz(step);
+		syndrome ^= syndromes[k];
+		subset ^= 1u << k;
+	}
+	if(d_cache->contains(syndrome, now))
+	{
+		if(!found)
+			correction = subset;
+		if(++found > 1)
+			break;
+	}
+    }
+    return found;
+}
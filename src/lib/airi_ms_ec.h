@@ -0,0 +1,116 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_EC_H
+#define INCLUDED_AIRI_MS_EC_H
+
+#include <vector>
+
+class ms_frame_raw;
+class ms_address_cache;
+class ms_ec_memo;
+
+// Most low confidence bits a search can take, a subset is a bit mask
+const int MS_EC_MAX_LCBS = 24;
+
+/*
+ * Meet in the middle search for the subsets of a set of syndromes that XOR
+ * to a target syndrome
+ *
+ * The set is split in half.  Every subset of the first half is hashed by its
+ * syndrome, then every subset of the second half looks up the syndrome it
+ * needs from the first half.  Both halves step through their subsets in Gray
+ * code order so each step is one XOR.  A search of n syndromes costs about
+ * 2^(n/2) steps each way instead of 2^n.
+ */
+class ms_ec_search
+{
+public:
+    ms_ec_search();
+
+    // Number of non empty subsets of the n syndromes that XOR to target, the
+    // search stops at two.  The first subset found is put in correction.
+    int solve(const unsigned int *syndromes, int n, unsigned int target, unsigned int &correction);
+
+private:
+    struct entry
+    {
+	unsigned int syndrome;
+	unsigned int subset;     // Latest subset of the first half with this syndrome
+	unsigned int count;      // Subsets with this syndrome
+	unsigned int epoch;      // Entry is in use if this is the current epoch
+    };
+
+    std::vector<entry> d_entries;
+    unsigned int d_epoch;
+};
+
+/*
+ * Error correction of a frame by flipping low confidence bits
+ *
+ * One and two bit errors are looked up in the syndrome table, anything else
+ * is searched for.  Only a unique solution is used.  With an address cache,
+ * frames with the address overlaid on the parity are first searched for a
+ * solution that leaves a cached address.  The outcomes of the other searches
+ * are remembered so a repeated frame is not searched again.  A corrector is not thread
+ * safe, each thread needs its own.
+ */
+class ms_ec_corrector
+{
+public:
+    ms_ec_corrector(int max_lcbs, ms_address_cache *cache = 0);
+    ~ms_ec_corrector();
+
+    // Handle a frame that needs no search, false if it needs correct()
+    bool quick(ms_frame_raw &frame);
+    // Correct a frame and set its quality
+    void correct(ms_frame_raw &frame);
+
+    int max_lcbs() const { return d_max_lcbs; }
+
+    // Counters
+    unsigned long table_corrections() const { return d_table_corrections; }
+    unsigned long search_corrections() const { return d_search_corrections; }
+    unsigned long address_corrections() const { return d_address_corrections; }
+    unsigned long skipped_frames() const { return d_skipped; }  // Frames with too many low confidence bits
+    unsigned long memo_hits() const;      // Frames with a remembered outcome
+    unsigned long memo_misses() const;
+
+private:
+    // Not copyable, the memo is owned
+    ms_ec_corrector(const ms_ec_corrector &);
+    ms_ec_corrector &operator=(const ms_ec_corrector &);
+
+    void solve(ms_frame_raw &frame);
+    bool address_search_applies(const ms_frame_raw &frame) const;
+    int address_search(const unsigned int *syndromes, int n, unsigned int target, unsigned int now, unsigned int &correction);
+
+    int d_max_lcbs;            // Frames with more low confidence bits are not corrected
+    ms_address_cache *d_cache; // Address cache or null
+    ms_ec_search d_search;
+    ms_ec_memo *d_memo;        // Outcomes of earlier searches
+    unsigned long d_table_corrections;
+    unsigned long d_search_corrections;
+    unsigned long d_address_corrections;
+    unsigned long d_skipped;
+};
+
+#endif /* INCLUDED_AIRI_MS_EC_H */
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <airi_ms_ec_memo.h>
+#include <air_ms_types.h>
+
+const int MS_EC_MEMO_KEY = 2*MS_FRAME_BYTES + 1;
+
+ms_ec_memo::ms_ec_memo(int entries, int max_age) :
+    d_entries(entries),
+    d_head(-1),
+    d_tail(-1),
+    d_max_age(max_age),
+    d_hits(0),
+    d_misses(0)
+{
+    int buckets = 1;
+    while(buckets < entries)
+	buckets <<= 1;
+    d_buckets.assign(2*buckets, -1);
+    // All entries start unused in the use order
+    for(int e = 0; e < entries; e++)
+    {
+	d_entries[e].valid = false;
+	d_entries[e].chain = -1;
+	push_front(e);
+    }
+}
+
+void ms_ec_memo::make_key(const ms_frame_raw &frame, unsigned char *key, unsigned int &hash) const
+{
+    // Only the bits up to the frame length count
+    int bytes = (frame.length() == MS_LONG_FRAME_LENGTH) ? MS_FRAME_BYTES : MS_FRAME_BYTES/2;
+    memset(key, 0, MS_EC_MEMO_KEY);
+    memcpy(key, frame.bits(), bytes);
+    memcpy(key + MS_FRAME_BYTES, frame.lcbs(), bytes);
+    key[2*MS_FRAME_BYTES] = frame.length();
+    // FNV-1a
+    hash = 2166136261u;
+    for(int k = 0; k < MS_EC_MEMO_KEY; k++)
+	hash = (hash ^ key[k]) * 16777619u;
+}
+
+void ms_ec_memo::unlink(int e)
+{
+    entry &x = d_entries[e];
+    if(x.prev >= 0)
+	d_entries[x.prev].next = x.next;
+    else
+	d_head = x.next;
+    if(x.next >= 0)
+	d_entries[x.next].prev = x.prev;
+    else
+	d_tail = x.prev;
+}
+
+void ms_ec_memo::push_front(int e)
+{
+    entry &x = d_entries[e];
+    x.prev = -1;
+    x.next = d_head;
+    if(d_head >= 0)
+	d_entries[d_head].prev = e;
+    d_head = e;
+    if(d_tail < 0)
+	d_tail = e;
+}
+
+// Take an entry out of its hash bucket and make it the next one reused
+void ms_ec_memo::remove(int e)
+{
+    entry &x = d_entries[e];
+    int *link = &d_buckets[x.hash & (d_buckets.size() - 1)];
+    while(*link != e)
+	link = &d_entries[*link].chain;
+    *link = x.chain;
+    x.chain = -1;
+    x.valid = false;
+    unlink(e);
+    // Append at the tail
+    x.next = -1;
+    x.prev = d_tail;
+    if(d_tail >= 0)
+	d_entries[d_tail].next = e;
+    d_tail = e;
+    if(d_head < 0)
+	d_head = e;
+}
+
+bool ms_ec_memo::find(const ms_frame_raw &frame, unsigned char *flips, unsigned short &quality)
+{
+    unsigned char key[MS_EC_MEMO_KEY];
+    unsigned int hash;
+    make_key(frame, key, hash);
+    for(int e = d_buckets[hash & (d_buckets.size() - 1)]; e >= 0; e = d_entries[e].chain)
+    {
+	entry &x = d_entries[e];
+	if((x.hash != hash) || memcmp(x.key, key, MS_EC_MEMO_KEY))
+		continue;
+	if((int)(frame.rx_time() - x.used) > d_max_age)
+	{
+		remove(e);   // Too old
+		break;
+	}
+	memcpy(flips, x.flips, MS_FRAME_BYTES);
+	quality = x.quality;
+	x.used = frame.rx_time();
+	unlink(e);
+	push_front(e);
+	d_hits++;
+	return true;
+    }
+    d_misses++;
+    return false;
+}
+
+void ms_ec_memo::insert(const ms_frame_raw &frame, const unsigned char *flips, unsigned short quality)
+{
+    // Reuse the least recently used entry
+    int e = d_tail;
+    if(e < 0)
+	return;
+    if(d_entries[e].valid)
+	remove(e);
+    entry &x = d_entries[e];
+    make_key(frame, x.key, x.hash);
+    memcpy(x.flips, flips, MS_FRAME_BYTES);
+    x.quality = quality;
+    x.used = frame.rx_time();
+    x.valid = true;
+    int &bucket = d_buckets[x.hash & (d_buckets.size() - 1)];
+    x.chain = bucket;
+    bucket = e;
+    unlink(e);
+    push_front(e);
+}
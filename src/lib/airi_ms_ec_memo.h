@@ -0,0 +1,80 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_EC_MEMO_H
+#define INCLUDED_AIRI_MS_EC_MEMO_H
+
+#include <vector>
+#include <air_ms_consts.h>   // For Mode S const values
+
+class ms_frame_raw;
+
+/*
+ * Least recently used cache of error correction outcomes
+ *
+ * The key is the frame length, bits and low confidence bits, and the
+ * outcome is the bits flipped and the quality.  Repeats of a squitter with
+ * the same bits hit by the same interference then need no search.  The
+ * number of entries is fixed, and an entry not used for max_age seconds is
+ * dropped so old aircraft do not keep their entries.
+ */
+class ms_ec_memo
+{
+public:
+    ms_ec_memo(int entries, int max_age);
+
+    // Outcome of an earlier correction of the same frame, false if none
+    bool find(const ms_frame_raw &frame, unsigned char *flips, unsigned short &quality);
+    // Remember the outcome of a correction, flips is the XOR of the bits after and before
+    void insert(const ms_frame_raw &frame, const unsigned char *flips, unsigned short quality);
+
+    // Counters
+    unsigned long hits() const { return d_hits; }
+    unsigned long misses() const { return d_misses; }
+
+private:
+    struct entry
+    {
+	unsigned char key[2*MS_FRAME_BYTES + 1];   // Bits, low confidence bits and length
+	unsigned char flips[MS_FRAME_BYTES];
+	unsigned short quality;
+	unsigned int used;      // rx_time of the latest use
+	unsigned int hash;
+	int chain;              // Next entry in the hash bucket, -1 at the end
+	int prev, next;         // Use order, most recent first
+	bool valid;
+    };
+
+    void make_key(const ms_frame_raw &frame, unsigned char *key, unsigned int &hash) const;
+    void unlink(int e);
+    void push_front(int e);
+    void remove(int e);
+
+    std::vector<entry> d_entries;
+    std::vector<int> d_buckets;    // First entry of each hash bucket, -1 if none
+    int d_head;                    // Most recently used
+    int d_tail;                    // Least recently used
+    int d_max_age;
+    unsigned long d_hits;
+    unsigned long d_misses;
+};
+
+#endif /* INCLUDED_AIRI_MS_EC_MEMO_H */
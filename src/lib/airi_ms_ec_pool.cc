@@ -0,0 +1,228 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <airi_ms_ec_pool.h>
+#include <airi_ms_ec.h>
+#include <boost/bind.hpp>
+
+ms_ec_workers::ms_ec_workers(int nthreads, int max_lcbs, int max_frames, double max_latency_ms, ms_address_cache *cache) :
+    d_slots(max_frames),
+    d_head(0),
+    d_tail(0),
+    d_queues((nthreads > 0) ? nthreads : 0),
+    d_max_latency(boost::posix_time::microseconds((long)(max_latency_ms * 1000.0))),
+    d_limit_latency(max_latency_ms > 0.0),
+    d_next_queue(0),
+    d_depth(0),
+    d_max_depth(0),
+    d_fast(0),
+    d_late(0),
+    d_stop(false)
+{
+    for(unsigned int k = 0; k < d_slots.size(); k++)
+	d_slots[k].state = free_slot;
+    // The frames that need no search, or all with no workers, are done by
+    // the adding thread with a corrector of its own
+    d_inline = new ms_ec_corrector(max_lcbs, cache);
+    for(int k = 0; k < nthreads; k++)
+	d_ec.push_back(new ms_ec_corrector(max_lcbs, cache));
+    for(int k = 0; k < nthreads; k++)
+	d_threads.create_thread(boost::bind(&ms_ec_workers::run, this, k));
+}
+
+ms_ec_workers::~ms_ec_workers()
+{
+    {
+	boost::mutex::scoped_lock lock(d_mutex);
+	d_stop = true;
+    }
+    d_work.notify_all();
+    d_threads.join_all();
+    for(unsigned int k = 0; k < d_ec.size(); k++)
+	delete d_ec[k];
+    delete d_inline;
+}
+
+int ms_ec_workers::space() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_slots.size() - (d_tail - d_head);
+}
+
+int ms_ec_workers::pending() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_tail - d_head;
+}
+
+void ms_ec_workers::push(const ms_frame_raw &frame)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    slot &s = d_slots[d_tail % d_slots.size()];
+    s.frame = frame;
+    s.seq = d_tail;
+    s.added = boost::get_system_time();
+    if(d_inline->quick(s.frame))
+    {
+	s.state = done_slot;
+	d_fast++;
+    }
+    else if(d_queues.empty())
+    {
+	d_inline->correct(s.frame);
+	s.state = done_slot;
+    }
+    else
+    {
+	s.state = queued_slot;
+	d_queues[d_next_queue].push_back(d_tail);
+	d_next_queue = (d_next_queue + 1) % d_queues.size();
+	if(++d_depth > d_max_depth)
+		d_max_depth = d_depth;
+	d_work.notify_one();
+    }
+    d_tail++;
+}
+
+bool ms_ec_workers::pop(ms_frame_raw &frame, bool wait)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if(d_head == d_tail)
+	return false;
+    slot &s = d_slots[d_head % d_slots.size()];
+    if((s.state != done_slot) && !wait)
+    {
+	// Not waiting, but still taken once it is too late so the frames
+	// behind it are not held up while more keep coming in
+	if(!d_limit_latency || (boost::get_system_time() < s.added + d_max_latency))
+		return false;
+    }
+    else if(s.state != done_slot)
+    {
+	while(s.state != done_slot)
+	{
+		if(!d_limit_latency)
+			d_done.wait(lock);
+		else if(!d_done.timed_wait(lock, s.added + d_max_latency))
+			break;
+	}
+    }
+    frame = s.frame;
+    if(s.state != done_slot)
+    {
+	// Too late, a worker still on it drops its result
+	frame.set_ec_quality(ms_frame_raw::eq_ec_deferred);
+	d_late++;
+    }
+    s.state = free_slot;
+    d_head++;
+    return true;
+}
+
+// Claim a queued frame, own queue first then steal from the others
+bool ms_ec_workers::take(int id, unsigned long &seq)
+{
+    int n = d_queues.size();
+    if(!d_queues[id].empty())
+    {
+	seq = d_queues[id].front();
+	d_queues[id].pop_front();
+	return true;
+    }
+    for(int k = 1; k < n; k++)
+    {
+	std::deque<unsigned long> &q = d_queues[(id + k) % n];
+	if(!q.empty())
+	{
+		seq = q.back();
+		q.pop_back();
+		return true;
+	}
+    }
+    return false;
+}
+
+void ms_ec_workers::run(int id)
+{
+    ms_frame_raw frame;
+    unsigned long seq;
+    boost::mutex::scoped_lock lock(d_mutex);
+    for(;;)
+    {
+	while(!d_stop && !take(id, seq))
+		d_work.wait(lock);
+	if(d_stop)
+		return;
+	slot &s = d_slots[seq % d_slots.size()];
+	if((s.seq != seq) || (s.state != queued_slot))
+	{
+		d_depth--;    // Taken late
+		continue;
+	}
+	s.state = busy_slot;
+	frame = s.frame;
+	// Correct a copy without the lock so a late frame can be taken meanwhile
+	lock.unlock();
+	correct(id, frame);
+	lock.lock();
+	d_depth--;
+	if((s.seq == seq) && (s.state == busy_slot))
+	{
+		s.frame = frame;
+		s.state = done_slot;
+		if(seq == d_head)
+			d_done.notify_all();
+	}
+    }
+}
+
+void ms_ec_workers::correct(int id, ms_frame_raw &frame)
+{
+    d_ec[id]->correct(frame);
+}
+
+int ms_ec_workers::queue_depth() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_depth;
+}
+
+int ms_ec_workers::max_queue_depth() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_max_depth;
+}
+
+unsigned long ms_ec_workers::fast_frames() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_fast;
+}
+
+unsigned long ms_ec_workers::late_frames() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_late;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_EC_POOL_H
+#define INCLUDED_AIRI_MS_EC_POOL_H
+
+#include <deque>
+#include <vector>
+#include <boost/thread.hpp>
+#include <air_ms_types.h>
+
+class ms_ec_corrector;
+class ms_address_cache;
+
+/*
+ * Error correction of frames by a pool of worker threads
+ *
+ * Frames go into a reorder buffer in arrival order, which is timestamp
+ * order, and come out in the same order.  Frames that need no search are
+ * done as they arrive.  The rest are queued round robin to the workers, and a
+ * worker with an empty queue steals from the back of the others.  With no
+ * workers the frames are corrected as they arrive.
+ */
+class ms_ec_workers
+{
+public:
+    // max_latency_ms of zero or less waits for every frame to be corrected
+    ms_ec_workers(int nthreads, int max_lcbs, int max_frames, double max_latency_ms, ms_address_cache *cache = 0);
+    virtual ~ms_ec_workers();
+
+    // Frames that can be added
+    int space() const;
+    // Frames added and not yet taken
+    int pending() const;
+    // Add a frame
+    void push(const ms_frame_raw &frame);
+    // Take the oldest frame if it is done, or uncorrected once it is the
+    // maximum latency from when it was added.  With wait true, wait for one
+    // or the other.  False if there is no frame to take.
+    bool pop(ms_frame_raw &frame, bool wait);
+
+    // Counters
+    int queue_depth() const;             // Frames queued or being corrected
+    int max_queue_depth() const;
+    unsigned long fast_frames() const;   // Frames that needed no search
+    unsigned long late_frames() const;   // Frames taken late as eq_ec_deferred
+
+protected:
+    // Correct a frame in worker id, without the lock.  A test can hold a
+    // worker up here.
+    virtual void correct(int id, ms_frame_raw &frame);
+
+private:
+    enum { free_slot, queued_slot, busy_slot, done_slot };
+    struct slot
+    {
+	ms_frame_raw frame;
+	unsigned long seq;           // Sequence number of the frame in the slot
+	int state;
+	boost::system_time added;
+    };
+
+    void run(int id);
+    bool take(int id, unsigned long &seq);
+
+    std::vector<slot> d_slots;               // Reorder buffer
+    unsigned long d_head;                    // Oldest frame
+    unsigned long d_tail;                    // Next frame
+    std::vector<std::deque<unsigned long> > d_queues;  // Sequence numbers to correct per worker
+    ms_ec_corrector *d_inline;               // For the adding thread
+    std::vector<ms_ec_corrector *> d_ec;     // One per worker
+    boost::posix_time::time_duration d_max_latency;
+    bool d_limit_latency;
+    int d_next_queue;
+    int d_depth;                 // Frames queued or being corrected
+    int d_max_depth;
+    unsigned long d_fast;
+    unsigned long d_late;
+    bool d_stop;
+    mutable boost::mutex d_mutex;
+    boost::condition_variable d_work;        // A frame was queued
+    boost::condition_variable d_done;        // A frame was corrected
+    boost::thread_group d_threads;
+};
+
+#endif /* INCLUDED_AIRI_MS_EC_POOL_H */
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <air_ms_types.h>
+#include <airi_ms_fmt_text.h>
+
+/*
+ * The short, extended and parity fields are whole nibbles of the packed bits
+ * so they come straight from a byte to hex table.  The other hex fields are
+ * written from the right to their width, and the reference level is printed
+ * as "%.5g" would, which is what the stream did with precision 5.
+ */
+
+// Two lower case hex digits for each byte
+struct ms_hex_table
+{
+    char digits[256][2];
+    ms_hex_table()
+    {
+	static const char hex[] = "0123456789abcdef";
+	for (int i = 0; i < 256; i++)
+	{
+		digits[i][0] = hex[i >> 4];
+		digits[i][1] = hex[i & 15];
+	}
+    }
+};
+static const ms_hex_table ms_hex;
+
+// Bytes as hex, the high nibble of the last one only if odd is set
+static inline char *ms_put_nibbles(char *p, const unsigned char *bytes, int n, bool odd = false)
+{
+    for (int i = 0; i < n; i++, p += 2)
+	memcpy(p, ms_hex.digits[bytes[i]], 2);
+    if(odd)
+	*p++ = ms_hex.digits[bytes[n]][0];
+    return p;
+}
+
+// Low nibble of the first byte then the following bytes as hex
+static inline char *ms_put_nibbles_low(char *p, const unsigned char *bytes, int n)
+{
+    *p++ = ms_hex.digits[bytes[0]][1];
+    return ms_put_nibbles(p, bytes + 1, n);
+}
+
+// Hex zero filled to width, more digits if it needs them
+static inline char *ms_put_hex(char *p, uint64_t v, int width)
+{
+    int n = (64 - __builtin_clzll(v | 1) + 3) >> 2;
+    if(n < width)
+	n = width;
+    for (int i = n - 1; i >= 0; i--, v >>= 4)
+	p[i] = ms_hex.digits[v & 15][1];
+    return p + n;
+}
+
+// Decimal from 0 to 999 filled to width
+static inline char *ms_put_dec(char *p, unsigned int v, int width, char fill)
+{
+    char d[3];
+    int n = 0;
+    do
+    {
+	d[n++] = '0' + v % 10;
+	v /= 10;
+    } while(v && (n < 3));
+    for (; width > n; width--)
+	*p++ = fill;
+    while(n)
+	*p++ = d[--n];
+    return p;
+}
+
+// Powers of ten exact in a double
+static const double ms_pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8 };
+
+/*
+ * "%.5g" of a float.  For levels from 1e-4 up to 1e5, the ones "%.5g" writes
+ * without an exponent, the level scaled by 10^(4-X) is exact in a double: a
+ * float has 24 significant bits and the odd part of 10^8 has 19.  Rounding it
+ * to an integer, ties to even, gives the five digits "%.5g" does, and X is
+ * the exponent that leaves five digits after rounding.  Other levels, zero
+ * and the ones that round up to 1e5 go to snprintf.
+ */
+static int ms_fmt_level(char *p, float level)
+{
+    double v = fabs((double)level);
+    if((v >= 1e-4) && (v < 1e5))
+    {
+	int x = (v >= 1.0) ? ((v >= 100.0) ? ((v >= 1000.0) ? ((v >= 10000.0) ? 4 : 3) : 2) : ((v >= 10.0) ? 1 : 0))
+	                   : ((v >= 0.01) ? ((v >= 0.1) ? -1 : -2) : ((v >= 0.001) ? -3 : -4));
+	double n = rint(v * ms_pow10[4 - x]);
+	if(n >= 100000.0)
+	{
+		n /= 10.0;   // Rounded up to the next power of ten, exactly 10000
+		x++;
+	}
+	if(x < 5)
+	{
+		char d[5];
+		unsigned int u = (unsigned int)n;
+		for (int i = 4; i >= 0; i--, u /= 10)
+			d[i] = '0' + u % 10;
+		int digits = 5;   // Trailing zeros of the fraction are not written
+		while((digits > x + 1) && (d[digits - 1] == '0'))
+			digits--;
+		char *s = p;
+		if(level < 0)
+			*s++ = '-';
+		if(x >= 0)
+		{
+			memcpy(s, d, x + 1);
+			s += x + 1;
+			if(digits > x + 1)
+			{
+				*s++ = '.';
+				memcpy(s, d + x + 1, digits - x - 1);
+				s += digits - x - 1;
+			}
+		}
+		else
+		{
+			*s++ = '0';
+			*s++ = '.';
+			for (int i = -1; i > x; i--)
+				*s++ = '0';
+			memcpy(s, d, digits);
+			s += digits;
+		}
+		return s - p;
+	}
+    }
+    return snprintf(p, 32, "%.5g", (double)level);
+}
+
+int ms_fmt_text(const ms_frame_raw &frame, char *line)
+{
+    const unsigned char *bits = frame.bits();
+    char *p = line;
+    p = ms_put_nibbles(p, bits, 4);                 // Bits 0 to 31
+    *p++ = FIELD_DELIM;
+    if(frame.length() >= MS_LONG_FRAME_LENGTH)
+    {
+	p = ms_put_nibbles(p, bits + 4, 3, true);   // Bits 32 to 59
+	p = ms_put_nibbles_low(p, bits + 7, 3);     // Bits 60 to 87
+	*p++ = FIELD_DELIM;
+	p = ms_put_nibbles(p, bits + 11, 3);        // Bits 88 to 111
+    }
+    else
+    {
+	memset(p, ' ', 15);
+	p[0] = p[14] = FIELD_DELIM;
+	p += 15;
+	p = ms_put_nibbles(p, bits + 4, 3);         // Bits 32 to 55
+    }
+    *p++ = FIELD_DELIM;
+
+    char level[32];
+    int n = ms_fmt_level(level, frame.reference());
+    for (int i = n; i < 7; i++)                     // Right aligned
+	*p++ = ' ';
+    memcpy(p, level, n);
+    p += n;
+    *p++ = FIELD_DELIM;
+
+    p = ms_put_hex(p, frame.timestamp(), 8);
+    *p++ = FIELD_DELIM;
+    p = ms_put_hex(p, (uint64_t)frame.rx_time(), 0);
+    *p++ = FIELD_DELIM;
+    p = ms_put_dec(p, frame.lcb_count(), 3, ' ');
+    *p++ = FIELD_DELIM;
+    p = ms_put_hex(p, frame.ec_quality(), 8);
+    *p++ = FIELD_DELIM;
+    p = ms_put_dec(p, bits[0] >> 3, 2, '0');        // Downlink format
+    *p++ = FIELD_DELIM;
+    p = ms_put_hex(p, frame.address(), 6);
+    return p - line;
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_FMT_TEXT_H
+#define INCLUDED_AIRI_MS_FMT_TEXT_H
+
+class ms_frame_raw;
+
+// Between the fields of a line
+#define FIELD_DELIM ((unsigned char)32)
+
+// Longest text log line
+const int MS_FMT_TEXT_MAX = 128;
+
+// One text log line for a frame in the layout described in air_ms_fmt_log.cc,
+// the same bytes the iostream formatting gave.  Writes up to MS_FMT_TEXT_MAX
+// bytes, without the newline or a terminating null, and returns how many.
+int ms_fmt_text(const ms_frame_raw &frame, char *line);
+
+#endif /* INCLUDED_AIRI_MS_FMT_TEXT_H */
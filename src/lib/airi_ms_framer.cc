@@ -0,0 +1,192 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <air_ms_types.h>
+#include <airi_ms_framer.h>
+#include <airi_ms_ppm.h>
+#include <airi_ms_address.h>
+
+// Frame length of each downlink format, zero for the formats not in use
+static const int ms_df_length[32] =
+{
+    MS_SHORT_FRAME_LENGTH, 0, 0, 0,                     // DF0 Short air-air surveillance (ACAS)
+    MS_SHORT_FRAME_LENGTH, MS_SHORT_FRAME_LENGTH, 0, 0, // DF4/5 Surveillance altitude and identity replies
+    0, 0, 0, MS_SHORT_FRAME_LENGTH,                     // DF11 All-call reply
+    0, 0, 0, 0,
+    MS_LONG_FRAME_LENGTH, MS_LONG_FRAME_LENGTH,         // DF16 Long air-air surveillance, DF17 Extended squitter
+    MS_LONG_FRAME_LENGTH, MS_LONG_FRAME_LENGTH,         // DF18 Extended squitter non transponder, DF19 Military
+    MS_LONG_FRAME_LENGTH, MS_LONG_FRAME_LENGTH,         // DF20/21 Comm-B altitude and identity replies
+    MS_LONG_FRAME_LENGTH, 0,                            // DF22 Military
+    MS_LONG_FRAME_LENGTH, MS_LONG_FRAME_LENGTH,         // DF24 Comm-D (ELM) only has the first two bits set
+    MS_LONG_FRAME_LENGTH, MS_LONG_FRAME_LENGTH,
+    MS_LONG_FRAME_LENGTH, MS_LONG_FRAME_LENGTH,
+    MS_LONG_FRAME_LENGTH, MS_LONG_FRAME_LENGTH
+};
+
+int ms_df_frame_length(int df)
+{
+    return ms_df_length[df & 31];
+}
+
+template <int RATE>
+ms_framer_kernel<RATE>::ms_framer_kernel(int channel_rate) :
+    d_rate(channel_rate),
+    d_slicer(channel_rate),
+    d_format_frames(0),
+    d_pulse_frames(0),
+    d_rejected_frames(0)
+{
+}
+
+template <int RATE>
+template <typename T>
+int ms_framer_kernel<RATE>::frame_width(const T *data_in, const ms_plinfo *attrib_in, int i,
+                                        typename ms_sample_traits<T>::level reference) const
+{
+	ms_frame_raw format;
+	int bit_index;
+	int frame_end;
+	int start = i + d_rate.data_start;
+	// Slice just the downlink format, a bit cut by the end is still sliced
+	d_slicer.slice(data_in, attrib_in, start, i + d_rate.max_frame_width, start + MS_DF_LENGTH * d_rate.bit_width,
+	                reference, format, bit_index, frame_end);
+	if((bit_index + (frame_end ? 1 : 0) < MS_DF_LENGTH) || (format.lcbs()[0] >> (8 - MS_DF_LENGTH)))
+	{
+		d_pulse_frames++;
+		return pulse_frame_width(data_in, attrib_in, i, reference);
+	}
+	switch(ms_df_frame_length(ms_downlink_format(format)))
+	{
+	case MS_SHORT_FRAME_LENGTH:
+		d_format_frames++;
+		return d_rate.min_frame_width;
+	case MS_LONG_FRAME_LENGTH:
+		d_format_frames++;
+		return d_rate.max_frame_width;
+	default:
+		d_rejected_frames++;
+		return 0;
+	}
+}
+
+template <int RATE>
+template <typename T>
+int ms_framer_kernel<RATE>::pulse_frame_width(const T *data_in, const ms_plinfo *attrib_in, int i,
+                                              typename ms_sample_traits<T>::level reference) const
+{
+	typedef ms_sample_traits<T> traits;
+	int j, k;
+	int offset;
+	int frame_size;
+	typename traits::level max_level;
+	typename traits::level low_limit = traits::lower_reference_limit(reference, ms_db_minus_6);
+	// There is a short 56 bit frame and a long 112 bit frame
+	// So figure out the frame size
+	// Assume maximum frame size
+	frame_size = d_rate.max_frame_width;
+	// Do a similar DF Valid technique for bits 57 through 62
+	offset = i + d_rate.min_frame_width;
+	for( j = 0; j < (5 * d_rate.bit_width); j += d_rate.bit_width)
+	{
+		int chips;
+		int leflag;
+        	int jj;
+		max_level = 0.;
+		chips = 0;
+		leflag = 0;
+		k = 0;
+		if(attrib_in[offset+j].valid_pulse())
+		{
+			chips++;
+			max_level = data_in[offset+j]; // init maximum level
+			leflag = 1;
+		}
+		else // look at +/- 1 bit for valid pulse
+		{
+			for(k = -1; k < 2; k += 2)
+			{
+				if(attrib_in[offset+j+k].valid_pulse())
+				{
+					chips++;
+					max_level = data_in[offset+j+k]; // init maximum level
+					leflag = 1;
+					break;
+				}
+			}
+        	}
+		if(leflag)
+		{
+			for(jj = 0; jj < d_rate.var_m; jj++)
+			{
+				if(data_in[offset+j+k+jj] > max_level)
+					max_level = data_in[offset+j+k+jj];
+			}
+		}
+        	// Look at the second chip now
+		leflag = 0;
+        	k = d_rate.chip_width;
+		if(attrib_in[offset+j+k].valid_pulse())
+		{
+			chips++;
+			max_level = data_in[offset+j+k]; // init maximum level
+			leflag = 1;
+		}
+		else // look at +/- 1 bit for valid pulse
+		{
+			for(k = d_rate.chip_width -1; k < d_rate.chip_width+2; k += 2)
+			{
+				if(attrib_in[offset+j+k].valid_pulse())
+				{
+					chips++;
+					max_level = data_in[offset+j+k];
+					leflag = 1;
+					break;
+				}
+			}
+		}
+		if(leflag)
+		{
+			for(jj = 0; jj < d_rate.var_m; jj++)
+			{
+				if(data_in[offset+j+k+jj] > max_level)
+					max_level = data_in[offset+j+k+jj];
+			}
+		}
+		if ((chips == 0) || (max_level < low_limit))  // If no valid bits at 57 - 62 so 56 bit frame
+		{
+			frame_size = d_rate.min_frame_width;
+			break;
+		}
+	}
+	return frame_size;
+}
+
+#define MS_FRAMER_KERNEL_INSTANTIATE(RATE) \
+    template class ms_framer_kernel<RATE>; \
+    template int ms_framer_kernel<RATE>::frame_width<float>(const float *, const ms_plinfo *, int, float) const; \
+    template int ms_framer_kernel<RATE>::frame_width<unsigned short>(const unsigned short *, const ms_plinfo *, int, \
+                                                                     unsigned int) const;
+
+MS_FOR_EACH_RATE(MS_FRAMER_KERNEL_INSTANTIATE)
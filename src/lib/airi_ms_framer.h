@@ -0,0 +1,76 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_FRAMER_H
+#define INCLUDED_AIRI_MS_FRAMER_H
+
+#include <airi_ms_sample.h>
+#include <airi_ms_rate.h>
+#include <airi_ms_ppm.h>
+
+class ms_plinfo;
+
+// Frame length of a downlink format in bits, zero for the formats not in use
+int ms_df_frame_length(int df);
+
+/*
+ * Mode S frame length shared by the framer and demodulator blocks
+ *
+ * The downlink format in the first five bits gives the frame length, and a
+ * frame with a format that is not used is no frame.  If a format bit is of low
+ * confidence the frame is long if there are valid data bits with enough power
+ * in bits 57 through 62, otherwise it is short.  Built for the channel rates in
+ * airi_ms_rate.h.
+ */
+template <int RATE>
+class ms_framer_kernel
+{
+public:
+    ms_framer_kernel(int channel_rate);
+
+    // Samples from the preamble start at i to the end of the frame, zero if the
+    // downlink format is not valid.  Reads up to max_frame_width past i.
+    template <typename T>
+    int frame_width(const T *data_in, const ms_plinfo *attrib_in, int i,
+                    typename ms_sample_traits<T>::level reference) const;
+
+    int data_start() const { return d_rate.data_start; }
+    int min_frame_width() const { return d_rate.min_frame_width; }
+    int max_frame_width() const { return d_rate.max_frame_width; }
+
+    // Counters
+    unsigned long format_frames() const { return d_format_frames; }   // Length from the downlink format
+    unsigned long pulse_frames() const { return d_pulse_frames; }     // Length from bits 57 through 62
+    unsigned long rejected_frames() const { return d_rejected_frames; }  // Format not valid
+
+private:
+    template <typename T>
+    int pulse_frame_width(const T *data_in, const ms_plinfo *attrib_in, int i,
+                          typename ms_sample_traits<T>::level reference) const;
+
+    ms_rate<RATE> d_rate;        // Sample positions and widths
+    ms_ppm_slicer<RATE> d_slicer; // Slices the downlink format
+    mutable unsigned long d_format_frames;
+    mutable unsigned long d_pulse_frames;
+    mutable unsigned long d_rejected_frames;
+};
+
+#endif /* INCLUDED_AIRI_MS_FRAMER_H */
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <air_ms_binlog.h>
+#include <airi_ms_log_writer.h>
+
+static boost::posix_time::time_duration ms_seconds(double s)
+{
+    return boost::posix_time::microseconds((long long)(s * 1e6));
+}
+
+ms_log_writer::ms_log_writer(const char *filename, bool binary, int sync, uint64_t rotate_bytes,
+                             double rotate_seconds, double flush_seconds, size_t buffer_bytes) :
+    d_filename(filename),
+    d_binary(binary),
+    d_sync(sync),
+    d_rotate_bytes(rotate_bytes),
+    d_rotate_interval(ms_seconds(rotate_seconds)),
+    d_rotate_timed(rotate_seconds > 0.0),
+    d_flush_interval(ms_seconds(flush_seconds)),
+    d_flush_timed(flush_seconds > 0.0),
+    d_fd(-1),
+    d_file_bytes(0),
+    d_rotated(0),
+    d_empty_bytes(binary ? MS_BINLOG_HEADER_SIZE : 0),
+    d_buffer_bytes((buffer_bytes > 4096) ? buffer_bytes : 4096),
+    d_draining(false),
+    d_flush(false),
+    d_failed(false),
+    d_stop(false),
+    d_bytes(0),
+    d_files(0),
+    d_waits(0)
+{
+    d_fill.reserve(d_buffer_bytes);
+    d_drain.reserve(d_buffer_bytes);
+    if(open_file())
+	d_thread = boost::thread(boost::bind(&ms_log_writer::run, this));
+}
+
+ms_log_writer::~ms_log_writer()
+{
+    {
+	boost::mutex::scoped_lock lock(d_mutex);
+	d_stop = true;
+    }
+    d_ready.notify_one();
+    if(d_thread.joinable())
+	d_thread.join();
+    if(d_fd >= 0)
+    {
+	if(d_sync != sync_none)
+		fsync(d_fd);
+	close(d_fd);
+    }
+}
+
+bool ms_log_writer::open_file()
+{
+    if(d_binary)
+	d_fd = ms_binlog_open(d_filename.c_str(), d_error);
+    else if((d_fd = open(d_filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0)
+	d_error = d_filename + ": " + strerror(errno);
+    struct stat st;
+    if((d_fd >= 0) && (fstat(d_fd, &st) < 0))
+    {
+	d_error = d_filename + ": " + strerror(errno);
+	close(d_fd);
+	d_fd = -1;
+    }
+    if(d_fd < 0)
+	return false;
+    d_file_bytes = st.st_size;
+    d_opened = boost::get_system_time();
+    return true;
+}
+
+// Rename the current file with the time and start another
+bool ms_log_writer::rotate()
+{
+    if(d_sync != sync_none)
+	fsync(d_fd);
+    close(d_fd);
+    d_fd = -1;
+    char stamp[32];
+    time_t now = time(0);
+    struct tm tm;
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", gmtime_r(&now, &tm));
+    std::string name = d_filename + "." + stamp;
+    for (int k = 1; access(name.c_str(), F_OK) == 0; k++)
+    {
+	char suffix[16];
+	snprintf(suffix, sizeof(suffix), ".%d", k);
+	name = d_filename + "." + stamp + suffix;
+    }
+    if(rename(d_filename.c_str(), name.c_str()) < 0)
+    {
+	d_error = d_filename + ": " + strerror(errno);
+	return false;
+    }
+    d_rotated++;
+    return open_file();
+}
+
+// Write a buffer of whole records, from the writer thread
+bool ms_log_writer::output(const std::vector<char> &buffer)
+{
+    if(buffer.empty())
+	return true;
+    if(d_file_bytes > d_empty_bytes)
+    {
+	bool full = d_rotate_bytes && (d_file_bytes + buffer.size() > d_rotate_bytes);
+	bool old = d_rotate_timed && (boost::get_system_time() - d_opened >= d_rotate_interval);
+	if((full || old) && !rotate())
+		return false;
+    }
+    if(!ms_binlog_write(d_fd, &buffer[0], buffer.size()))
+    {
+	d_error = d_filename + ": " + strerror(errno);
+	return false;
+    }
+    d_file_bytes += buffer.size();
+    if(d_sync == sync_write)
+	fdatasync(d_fd);
+    return true;
+}
+
+void ms_log_writer::run()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    for (;;)
+    {
+	boost::system_time flush_at = boost::get_system_time() + d_flush_interval;
+	while(!d_draining && !d_flush && !d_stop)
+	{
+		if(!d_flush_timed)
+			d_ready.wait(lock);
+		else if(!d_ready.timed_wait(lock, flush_at))
+			break;  // Records have waited long enough
+	}
+	if(!d_draining)
+	{
+		if(d_fill.empty())
+		{
+			if(d_flush)
+			{
+				if((d_sync != sync_none) && !d_failed)
+					fsync(d_fd);
+				d_flush = false;
+				d_written.notify_all();
+			}
+			if(d_stop)
+				break;
+			continue;
+		}
+		d_fill.swap(d_drain);
+		d_draining = true;
+	}
+	bool ok = true;
+	if(!d_failed)
+	{
+		lock.unlock();
+		ok = output(d_drain);
+		if(!ok)
+			fprintf(stderr, "%s\n", d_error.c_str());
+		lock.lock();
+		if(ok)
+			d_bytes += d_drain.size();
+		d_files = d_rotated;
+	}
+	d_failed = d_failed || !ok;
+	d_drain.clear();
+	d_draining = false;
+	d_written.notify_all();
+    }
+}
+
+bool ms_log_writer::write(const char *data, size_t n)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    while(!d_failed && (d_fill.size() + n > d_buffer_bytes))
+    {
+	// Hand the fill buffer over once the writer has finished with the other
+	if(d_draining)
+	{
+		d_waits++;
+		while(d_draining)
+			d_written.wait(lock);
+		continue;
+	}
+	d_fill.swap(d_drain);
+	d_draining = true;
+	d_ready.notify_one();
+    }
+    if(d_failed)
+	return false;
+    d_fill.insert(d_fill.end(), data, data + n);
+    return true;
+}
+
+void ms_log_writer::flush()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if(!d_thread.joinable())
+	return;
+    d_flush = true;
+    d_ready.notify_one();
+    while(d_flush)
+	d_written.wait(lock);
+}
+
+unsigned long long ms_log_writer::bytes() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_bytes;
+}
+
+unsigned long ms_log_writer::files() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_files;
+}
+
+unsigned long ms_log_writer::waits() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_waits;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_LOG_WRITER_H
+#define INCLUDED_AIRI_MS_LOG_WRITER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/thread.hpp>
+
+/*
+ * Log file written by a thread of its own
+ *
+ * Records are copied into the fill buffer while the writer thread writes the
+ * other buffer to the file.  The buffers change places when the fill buffer
+ * is full, when it has waited flush_seconds and on flush().  When both are
+ * full the caller waits for the writer rather than the memory growing.
+ * Records never span a write so the file is rotated between them, when it
+ * would go past rotate_bytes or has been open rotate_seconds.  The file is
+ * renamed with the time it was rotated and a new file started.  A binary
+ * log is started and checked with ms_binlog_open.
+ */
+class ms_log_writer
+{
+public:
+    // When the file is synced to the disk
+    enum { sync_none, sync_close, sync_write };
+
+    ms_log_writer(const char *filename, bool binary, int sync, uint64_t rotate_bytes,
+                  double rotate_seconds, double flush_seconds, size_t buffer_bytes);
+    ~ms_log_writer();
+
+    // False with error() set if the file could not be opened
+    bool ok() const { return d_fd >= 0; }
+    const std::string &error() const { return d_error; }
+
+    // Add a record.  False if the file can no longer be written.
+    bool write(const char *data, size_t n);
+    // Write what is buffered and sync it unless sync is sync_none
+    void flush();
+
+    // Counters
+    unsigned long long bytes() const;   // Bytes written
+    unsigned long files() const;        // Files rotated
+    unsigned long waits() const;        // Times write() waited for the writer
+
+private:
+    // Not copyable, the thread and file are owned
+    ms_log_writer(const ms_log_writer &);
+    ms_log_writer &operator=(const ms_log_writer &);
+
+    bool open_file();
+    bool rotate();
+    bool output(const std::vector<char> &buffer);
+    void run();
+
+    std::string d_filename;
+    bool d_binary;
+    int d_sync;
+    uint64_t d_rotate_bytes;     // Zero for no size limit
+    boost::posix_time::time_duration d_rotate_interval;
+    bool d_rotate_timed;
+    boost::posix_time::time_duration d_flush_interval;
+    bool d_flush_timed;
+    int d_fd;                    // Current file, only the writer thread uses it once started
+    uint64_t d_file_bytes;       // Size of the current file
+    unsigned long d_rotated;     // Files rotated, the writer's copy of d_files
+    uint64_t d_empty_bytes;      // Size of a file with no records
+    boost::system_time d_opened; // When the current file was started
+    std::string d_error;
+
+    std::vector<char> d_fill;    // Records being added
+    std::vector<char> d_drain;   // Records being written
+    size_t d_buffer_bytes;
+    bool d_draining;             // d_drain is the writer's
+    bool d_flush;                // flush() is waiting
+    bool d_failed;               // The file could not be written
+    bool d_stop;
+    unsigned long long d_bytes;
+    unsigned long d_files;
+    unsigned long d_waits;
+    mutable boost::mutex d_mutex;
+    boost::condition_variable d_ready;    // Records to write or a flush or stop
+    boost::condition_variable d_written;  // d_drain is free again
+    boost::thread d_thread;
+};
+
+#endif /* INCLUDED_AIRI_MS_LOG_WRITER_H */
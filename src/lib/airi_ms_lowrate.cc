@@ -0,0 +1,207 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <air_ms_types.h>
+#include <airi_ms_lowrate.h>
+#include <airi_ms_framer.h>
+#include <airi_ms_address.h>
+
+// Chips of the preamble pulses and of the gaps between them
+static const int ms_preamble_pulse_chips[MS_PREAMBLE_PULSE_COUNT] = { 0, 2, 7, 9 };
+static const int ms_preamble_gap_chips[6] = { 1, 3, 4, 5, 6, 8 };
+
+static int gcd(int a, int b)
+{
+    while(b)
+    {
+	int r = a % b;
+	a = b;
+	b = r;
+    }
+    return a;
+}
+
+ms_lowrate_kernel::ms_lowrate_kernel(int channel_rate, float threshold) :
+    d_threshold(threshold),
+    d_candidates(0),
+    d_format_frames(0),
+    d_energy_frames(0),
+    d_rejected_frames(0)
+{
+    const int chip_rate = 2000000;
+    int g = gcd(channel_rate, chip_rate);
+    d_phases = chip_rate / g;
+    d_chip_ticks = channel_rate / g;
+    if(d_phases < 2)  // At least half sample steps
+    {
+	d_phases *= 2;
+	d_chip_ticks *= 2;
+    }
+    // A chip starting in the last tick of a sample touches this many samples
+    d_taps = (d_phases - 1 + d_chip_ticks + d_phases - 1) / d_phases;
+    d_weights.assign(d_phases * d_taps, 0.0);
+    for (int ph = 0; ph < d_phases; ph++)
+	for (int m = 0; m < d_taps; m++)
+	{
+		// Ticks of sample m inside the chip [ph, ph + d_chip_ticks)
+		int lo = (m * d_phases > ph) ? m * d_phases : ph;
+		int hi = ((m + 1) * d_phases < ph + d_chip_ticks) ? (m + 1) * d_phases : ph + d_chip_ticks;
+		if(hi > lo)
+			d_weights[ph * d_taps + m] = (float)(hi - lo) / d_chip_ticks;
+	}
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	d_pulse_samples[j] = ms_preamble_pulse_chips[j] * d_chip_ticks / d_phases;
+    // First sample after the start of chip 4 from the last tick of a sample, it
+    // ends before chip 7 at 2 and 2.4 Msps
+    d_gap_sample = (d_phases - 1 + 4 * d_chip_ticks + d_phases - 1) / d_phases;
+    // Preamble and long frame chips from the last tick of a sample, and the samples they touch
+    d_max_frame_width = frame_width(d_phases - 1, MS_LONG_FRAME_LENGTH) + d_taps;
+    // The pulse test reads up to two samples past a pulse start
+    d_preamble_width = frame_width(d_phases - 1, 0) + d_taps + 2;
+}
+
+bool ms_lowrate_kernel::preamble(const float *data, int t, float &reference, float &margin) const
+{
+    float pulses[MS_PREAMBLE_PULSE_COUNT];
+    float sum = 0.0;
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+    {
+	pulses[j] = chip(data, t + ms_preamble_pulse_chips[j] * d_chip_ticks);
+	sum += pulses[j];
+    }
+    reference = sum / MS_PREAMBLE_PULSE_COUNT;
+    if(reference < d_threshold)
+	return false;
+    float low_limit = reference * 0.59566;  // -4.5 dB
+    float high_limit = reference * 1.67880;  // +4.5 dB
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	if((pulses[j] < low_limit) || (pulses[j] > high_limit))
+		return false;
+    float gap_limit = reference * 0.79433;  // -2 dB
+    margin = sum;
+    for (int j = 0; j < 6; j++)
+    {
+	float f = chip(data, t + ms_preamble_gap_chips[j] * d_chip_ticks);
+	if(f > gap_limit)
+		return false;
+	margin -= f;
+    }
+    return true;
+}
+
+int ms_lowrate_kernel::find(const float *data, int i, int size, float &reference)
+{
+    for (; i < size; i++)
+    {
+	// Each pulse has a sample over the threshold in the samples it can touch
+	// and the sample in the gap from 2.0 to 3.5 uS is lower than all of them
+	int j;
+	float weakest = data[i + d_gap_sample];
+	for (j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	{
+		const float *p = data + i + d_pulse_samples[j];
+		float f = (p[0] > p[1]) ? p[0] : p[1];
+		if(p[2] > f)
+			f = p[2];
+		if((f < d_threshold) || (f <= weakest))
+			break;
+	}
+	if(j < MS_PREAMBLE_PULSE_COUNT)
+		continue;
+	d_candidates++;
+	float margin, best_margin = 0.0, level;
+	int best = -1;
+	for (int t = i * d_phases; t < (i + 1) * d_phases; t++)
+	{
+		if(!preamble(data, t, level, margin))
+			continue;
+		// Take the best tick up to a sample from the first
+		best = t;
+		best_margin = margin;
+		reference = level;
+		for (int end = t + d_phases, u = t + 1; u < end; u++)
+		{
+			if(preamble(data, u, level, margin) && (margin > best_margin))
+			{
+				best = u;
+				best_margin = margin;
+				reference = level;
+			}
+		}
+		return best;
+	}
+    }
+    return size * d_phases;
+}
+
+bool ms_lowrate_kernel::bit(const float *data, int t, int index, float reference, ms_frame_raw &frame) const
+{
+    float one = chip(data, t + (2 * MS_PREAMBLE_TIME_US + 2 * index) * d_chip_ticks);
+    float zero = chip(data, t + (2 * MS_PREAMBLE_TIME_US + 2 * index + 1) * d_chip_ticks);
+    float high = (one > zero) ? one : zero;
+    float low = (one > zero) ? zero : one;
+    float pulse_limit = reference * 0.5012;  // -6 dB
+    if((high >= pulse_limit) && (high - low >= reference * 0.2))
+	frame.set_bit_high_confidence(index, one > zero);
+    else if(high < reference * 0.31623)  // -10 dB
+	frame.set_bit_low_energy(index, one > zero);
+    else
+	frame.set_bit_low_confidence(index, one > zero);
+    return high >= pulse_limit;
+}
+
+int ms_lowrate_kernel::frame_length(const float *data, int t, float reference)
+{
+    ms_frame_raw format;
+    for (int b = 0; b < MS_DF_LENGTH; b++)
+	bit(data, t, b, reference, format);
+    if(!(format.lcbs()[0] >> (8 - MS_DF_LENGTH)))
+    {
+	int length = ms_df_frame_length(ms_downlink_format(format));
+	if(length)
+		d_format_frames++;
+	else
+		d_rejected_frames++;
+	return length;
+    }
+    // A format bit is of low confidence so the frame is long if most of
+    // bits 57 through 62 have a chip with the power of a pulse
+    int pulses = 0;
+    for (int b = MS_SHORT_FRAME_LENGTH; b < MS_SHORT_FRAME_LENGTH + 6; b++)
+	if(bit(data, t, b, reference, format))
+		pulses++;
+    d_energy_frames++;
+    return (pulses >= 3) ? MS_LONG_FRAME_LENGTH : MS_SHORT_FRAME_LENGTH;
+}
+
+void ms_lowrate_kernel::slice(const float *data, int t, float reference, int length, ms_frame_raw &frame) const
+{
+    for (int b = 0; b < length; b++)
+	bit(data, t, b, reference, frame);
+    if(length == MS_LONG_FRAME_LENGTH)
+	frame.set_long_frame();
+    else
+	frame.set_short_frame();
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_LOWRATE_H
+#define INCLUDED_AIRI_MS_LOWRATE_H
+
+#include <vector>
+#include <air_ms_consts.h>   // For Mode S const values
+
+class ms_frame_raw;
+
+/*
+ * Mode S demodulation at 2 to 2.4 Msps
+ *
+ * A chip is 0.5 uS, one sample at 2 Msps and 1.2 samples at 2.4 Msps, too
+ * few for the leading edge and pulse width tests of the 8 and 10 Msps blocks.
+ * Instead the level of each chip is the mean of the magnitude over the chip
+ * time, with the samples that are partly in the chip weighted by how much of
+ * them is.  Chips start on a grid of ticks, a fraction of a sample, fine
+ * enough that a chip is a whole number of ticks: half a sample at 2 Msps and
+ * a fifth of a sample at 2.4 Msps.
+ *
+ * A preamble is looked for at every tick whose pulses have a sample over the
+ * threshold, all higher than a sample in the gap after the second pulse.  The
+ * four preamble chips must be within 4.5 dB of their mean, the reference, and
+ * the six chips between them 2 dB below it.  The limits are wide as a pulse
+ * that straddles two samples is spread over three chips.  The tick with the
+ * most margin in the sample after the first that passes is taken.  A bit is
+ * one if its first chip has the higher level.  It is of high confidence if
+ * the higher chip is no more than 6 dB below the reference and the chips
+ * differ by a fifth of it, of low energy if both chips are 10 dB below it.
+ */
+class ms_lowrate_kernel
+{
+public:
+    ms_lowrate_kernel(int channel_rate, float threshold);
+
+    // Next preamble starting in the samples [i, size), as a tick, or size
+    // times ticks_per_sample() if there is none
+    int find(const float *data, int i, int size, float &reference);
+    // Frame length in bits for the preamble at tick t, zero if the downlink
+    // format is not valid
+    int frame_length(const float *data, int t, float reference);
+    // Slice length bits of the frame with the preamble at tick t
+    void slice(const float *data, int t, float reference, int length, ms_frame_raw &frame) const;
+
+    int ticks_per_sample() const { return d_phases; }
+    // Samples from the preamble start to the data start
+    int data_start(int t) const { return (t + 2 * MS_PREAMBLE_TIME_US * d_chip_ticks) / d_phases - t / d_phases; }
+    // Samples from the preamble start at tick t to the end of a frame of length bits
+    int frame_width(int t, int length) const
+    {
+	return (t % d_phases + 2 * (MS_PREAMBLE_TIME_US + MS_BIT_TIME_US * length) * d_chip_ticks) / d_phases;
+    }
+    // Samples read from a preamble start for a long frame and by the preamble checks
+    int max_frame_width() const { return d_max_frame_width; }
+    int preamble_width() const { return d_preamble_width; }
+
+    // Counters
+    unsigned long candidates() const { return d_candidates; }   // Samples given the full preamble check
+    unsigned long format_frames() const { return d_format_frames; }   // Length from the downlink format
+    unsigned long energy_frames() const { return d_energy_frames; }   // Length from bits 57 through 62
+    unsigned long rejected_frames() const { return d_rejected_frames; }  // Format not valid
+
+private:
+    float chip(const float *data, int t) const
+    {
+	const float *w = &d_weights[(t % d_phases) * d_taps];
+	const float *p = data + t / d_phases;
+	float level = 0.0;
+	for (int m = 0; m < d_taps; m++)
+		level += w[m] * p[m];
+	return level;
+    }
+    bool preamble(const float *data, int t, float &reference, float &margin) const;
+    bool bit(const float *data, int t, int index, float reference, ms_frame_raw &frame) const;
+
+    float d_threshold;       // Smallest pulse level
+    int d_phases;            // Ticks per sample
+    int d_chip_ticks;        // Ticks per chip
+    int d_taps;              // Samples a chip can touch
+    std::vector<float> d_weights;  // d_taps weights for a chip starting at each phase
+    int d_pulse_samples[MS_PREAMBLE_PULSE_COUNT];  // Sample offsets of the preamble pulses
+    int d_gap_sample;        // Sample offset inside the gap between the second and third pulses
+    int d_max_frame_width;
+    int d_preamble_width;
+    unsigned long d_candidates;
+    unsigned long d_format_frames;
+    unsigned long d_energy_frames;
+    unsigned long d_rejected_frames;
+};
+
+#endif /* INCLUDED_AIRI_MS_LOWRATE_H */
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+#include <airi_ms_mag.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MS_HAVE_AVX2_KERNEL 1
+#endif
+
+float ms_mag_threshold_sq(float threshold)
+{
+	if(threshold <= 0.0)
+		return -1.0;  // Every sample passes
+	float t = threshold * threshold;
+	// Walk to the exact boundary as the square may round either way
+	while((t > 0.0) && (sqrtf(nextafterf(t, 0.0)) >= threshold))
+		t = nextafterf(t, 0.0);
+	while(sqrtf(t) < threshold)
+		t = nextafterf(t, HUGE_VALF);
+	return t;
+}
+
+// Scalar kernel, also used for the tail of the vector kernels
+static void ms_mag_detect_generic(const gr_complex *in, float *mag, unsigned int *over,
+                                  float threshold_sq, int start, int n)
+{
+	for(int i = start; i < n; i++)
+	{
+		float re = in[i].real();
+		float im = in[i].imag();
+		float sq = re * re;
+		sq += im * im;
+		mag[i] = sqrtf(sq);
+		if(sq >= threshold_sq)
+			over[i >> 5] |= 1u << (i & 31);
+	}
+}
+
+#if defined(__SSE2__)
+// Four samples per iteration
+static int ms_mag_detect_sse2(const gr_complex *in, float *mag, unsigned int *over,
+                              float threshold_sq, int n)
+{
+	const float *p = (const float *)in;
+	__m128 t = _mm_set1_ps(threshold_sq);
+	int i;
+	for(i = 0; i + 4 <= n; i += 4)
+	{
+		__m128 a = _mm_loadu_ps(p + 2*i);      // r0 i0 r1 i1
+		__m128 b = _mm_loadu_ps(p + 2*i + 4);  // r2 i2 r3 i3
+		a = _mm_mul_ps(a, a);
+		b = _mm_mul_ps(b, b);
+		__m128 sq = _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)),
+		                       _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+		_mm_storeu_ps(mag + i, _mm_sqrt_ps(sq));
+		unsigned int bits = _mm_movemask_ps(_mm_cmpge_ps(sq, t));
+		over[i >> 5] |= bits << (i & 31);
+	}
+	return i;
+}
+#endif
+
+#if defined(MS_HAVE_AVX2_KERNEL)
+// Eight samples per iteration
+__attribute__((target("avx2")))
+static int ms_mag_detect_avx2(const gr_complex *in, float *mag, unsigned int *over,
+                              float threshold_sq, int n)
+{
+	const float *p = (const float *)in;
+	__m256 t = _mm256_set1_ps(threshold_sq);
+	int i;
+	for(i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 a = _mm256_loadu_ps(p + 2*i);      // samples 0 - 3
+		__m256 b = _mm256_loadu_ps(p + 2*i + 8);  // samples 4 - 7
+		a = _mm256_mul_ps(a, a);
+		b = _mm256_mul_ps(b, b);
+		// hadd leaves the samples in the order 0 1 4 5 2 3 6 7 so put them back
+		__m256 sq = _mm256_hadd_ps(a, b);
+		sq = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sq), 0xd8));
+		_mm256_storeu_ps(mag + i, _mm256_sqrt_ps(sq));
+		unsigned int bits = _mm256_movemask_ps(_mm256_cmp_ps(sq, t, _CMP_GE_OQ));
+		over[i >> 5] |= bits << (i & 31);
+	}
+	return i;
+}
+#endif
+
+// Magnitude of every unsigned 8 bit IQ pair, built once at startup
+class ms_mag_u8_lut
+{
+public:
+    ms_mag_u8_lut()
+    {
+	for(int i = 0; i < 256; i++)
+		for(int q = 0; q < 256; q++)
+		{
+			// As ms_mag_detect_generic so both give the same magnitude
+			float re = i - 127.5f;
+			float im = q - 127.5f;
+			float sq = re * re;
+			sq += im * im;
+			d_mag[(i << 8) | q] = sqrtf(sq);
+			d_mag_s[(i << 8) | q] = (unsigned short)(sqrtf(sq) * MS_U8_MAG_SCALE + 0.5f);
+		}
+    }
+
+    float d_mag[65536];  // Indexed by (I << 8) | Q
+    unsigned short d_mag_s[65536];  // In fixed point
+};
+
+static const ms_mag_u8_lut ms_mag_u8;
+
+void ms_mag_detect_u8(const unsigned char *in, float *mag, unsigned int *over,
+                      float threshold, int n)
+{
+	const float *lut = ms_mag_u8.d_mag;
+	for(int w = 0; w * 32 < n; w++)
+	{
+		int end = (w + 1) * 32;
+		if(end > n)
+			end = n;
+		unsigned int bits = 0;
+		for(int i = w * 32; i < end; i++)
+		{
+			float m = lut[(in[2*i] << 8) | in[2*i + 1]];
+			mag[i] = m;
+			bits |= (unsigned int)(m >= threshold) << (i & 31);
+		}
+		over[w] = bits;
+	}
+}
+
+void ms_mag_detect_u8(const unsigned char *in, unsigned short *mag, unsigned int *over,
+                      unsigned int threshold, int n)
+{
+	const unsigned short *lut = ms_mag_u8.d_mag_s;
+	for(int w = 0; w * 32 < n; w++)
+	{
+		int end = (w + 1) * 32;
+		if(end > n)
+			end = n;
+		unsigned int bits = 0;
+		for(int i = w * 32; i < end; i++)
+		{
+			unsigned int m = lut[(in[2*i] << 8) | in[2*i + 1]];
+			mag[i] = m;
+			bits |= (unsigned int)(m >= threshold) << (i & 31);
+		}
+		over[w] = bits;
+	}
+}
+
+void ms_mag_to_fixed(const float *mag, unsigned short *out, float scale, int n)
+{
+	int i = 0;
+#if defined(__SSE2__)
+	// Eight samples per iteration, offset by 32768 to use the signed saturating pack
+	__m128 s = _mm_set1_ps(scale);
+	__m128 top = _mm_set1_ps(65535.0f);
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128i bias = _mm_set1_epi32(32768);
+	__m128i flip = _mm_set1_epi16((short)0x8000);
+	for( ; i + 8 <= n; i += 8)
+	{
+		__m128 a = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(mag + i), s), half), top);
+		__m128 b = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(mag + i + 4), s), half), top);
+		__m128i ia = _mm_sub_epi32(_mm_cvttps_epi32(a), bias);
+		__m128i ib = _mm_sub_epi32(_mm_cvttps_epi32(b), bias);
+		_mm_storeu_si128((__m128i *)(out + i), _mm_xor_si128(_mm_packs_epi32(ia, ib), flip));
+	}
+#endif
+	for( ; i < n; i++)
+	{
+		float f = mag[i] * scale + 0.5f;
+		out[i] = (f < 65535.0f) ? (unsigned short)f : 65535;
+	}
+}
+
+template <typename T>
+void ms_pulse_attributes(const T *mag, T before, const unsigned int *over,
+                         ms_plinfo *attrib, const ms_db_ratio &alpha, int width, int n)
+{
+	typedef ms_sample_traits<T> traits;
+	int t_count = 0;  // Count of samples over the threshold
+	int nwords = (n + 31) / 32;
+
+	for (int i = 0; i < n; i++)
+		attrib[i].reset_all();  // No attributes to start
+
+	// Same as ms_pulse_detect but whole words of samples below threshold are skipped
+	for (int w = 0; w < nwords; w++)
+	{
+		unsigned int bits = over[w];
+		if(bits == 0)
+		{
+			t_count = 0;
+			continue;
+		}
+		int end = (w + 1) * 32;
+		if(end > n)
+			end = n;
+		for (int i = w * 32; i < end; i++)
+		{
+			if((bits >> (i & 31)) & 1)
+			{
+				if(++t_count > width) // Check there are enough samples above threshold
+				{
+					int pos = i - width;  // rewind and set attributes
+					T prev = (pos > 0) ? mag[pos - 1] : before;
+					attrib[pos].set_valid_pulse();
+					if((mag[pos] >= traits::lower_limit(prev, alpha)) &&
+					   (mag[pos + 1] < traits::lower_limit(mag[pos], alpha)))
+					{
+						attrib[pos].set_leading_edge();
+					}
+				}
+			}
+			else
+				t_count = 0;
+		}
+	}
+}
+
+template void ms_pulse_attributes<float>(const float *, float, const unsigned int *,
+                                         ms_plinfo *, const ms_db_ratio &, int, int);
+template void ms_pulse_attributes<unsigned short>(const unsigned short *, unsigned short, const unsigned int *,
+                                                  ms_plinfo *, const ms_db_ratio &, int, int);
+
+void ms_mag_detect(const gr_complex *in, float *mag, unsigned int *over,
+                   float threshold_sq, int n)
+{
+	int i = 0;
+	memset(over, 0, ((n + 31) / 32) * sizeof(unsigned int));
+#if defined(MS_HAVE_AVX2_KERNEL)
+	static const bool have_avx2 = __builtin_cpu_supports("avx2");
+	if(have_avx2)
+		i = ms_mag_detect_avx2(in, mag, over, threshold_sq, n);
+#endif
+#if defined(__SSE2__)
+	if(i == 0)
+		i = ms_mag_detect_sse2(in, mag, over, threshold_sq, n);
+#endif
+	ms_mag_detect_generic(in, mag, over, threshold_sq, i, n);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_MAG_H
+#define INCLUDED_AIRI_MS_MAG_H
+
+#include <gr_complex.h>
+#include <air_ms_types.h>
+#include <airi_ms_sample.h>
+
+/*
+ * Magnitude kernels for the Mode S front end
+ *
+ * ms_mag_detect computes the magnitude sqrt(I*I + Q*Q) of n complex samples and
+ * a bitmap of the samples whose magnitude squared is at or above threshold_sq.
+ * Bit k of over[w] is sample 32*w+k.  over must hold (n+31)/32 words.
+ * An AVX2 or SSE2 kernel is used when the processor has one.
+ */
+void ms_mag_detect(const gr_complex *in, float *mag, unsigned int *over,
+                   float threshold_sq, int n);
+
+/*
+ * Smallest magnitude squared whose sqrtf() is at or above threshold.
+ * Testing the squared value against this gives the same answer as testing
+ * the magnitude against threshold.
+ */
+float ms_mag_threshold_sq(float threshold);
+
+/*
+ * ms_mag_detect_u8 does the same for n interleaved unsigned 8 bit IQ pairs
+ * with 127.5 as zero, looking the magnitude of each pair up in a table of all
+ * 65536 of them.  The magnitude is in the units of the samples, 0 to 180.3,
+ * and is tested against threshold itself.
+ */
+void ms_mag_detect_u8(const unsigned char *in, float *mag, unsigned int *over,
+                      float threshold, int n);
+
+/*
+ * Fixed point version, the magnitude is MS_U8_MAG_SCALE times the above,
+ * rounded, and threshold is in the same units.
+ */
+const float MS_U8_MAG_SCALE = 256.0;
+void ms_mag_detect_u8(const unsigned char *in, unsigned short *mag, unsigned int *over,
+                      unsigned int threshold, int n);
+
+/*
+ * Fixed point magnitudes of n float magnitudes, scale times them rounded and
+ * limited to 65535.
+ */
+void ms_mag_to_fixed(const float *mag, unsigned short *out, float scale, int n);
+
+/*
+ * Valid pulse and leading edge attributes of n magnitudes from the bitmap of
+ * those at or above threshold, as ms_pulse_detect sets them.  A pulse is valid
+ * if it and the width samples after it are over, a valid pulse is a leading
+ * edge if it is alpha times the sample before, given as before for the first
+ * magnitude, and the sample after is not.  The attributes of the last width magnitudes
+ * are not known yet and are left clear.
+ */
+template <typename T>
+void ms_pulse_attributes(const T *mag, T before, const unsigned int *over,
+                         ms_plinfo *attrib, const ms_db_ratio &alpha, int width, int n);
+
+#endif /* INCLUDED_AIRI_MS_MAG_H */
@@ -27,7 +27,12 @@
 class ms_frame_raw;
 
 extern const unsigned int ms_parity_table[MS_LONG_FRAME_LENGTH];
+extern const unsigned int ms_crc24_table[256];
 
-int ms_check_parity(ms_frame_raw &frame);
+// Error syndrome of a 7 or 14 byte message, the parity is in the last three bytes
+unsigned int ms_crc24(const unsigned char *msg, int nbytes);
+
+// Error syndrome of a frame, frames that are not long are checked as short ones
+int ms_check_parity(const ms_frame_raw &frame);
 
 #endif /* INCLUDED_AIRI_MS_PARITY_H */
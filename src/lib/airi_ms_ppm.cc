@@ -0,0 +1,162 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <air_ms_types.h>
+#include <airi_ms_ppm.h>
+
+template <int RATE>
+ms_ppm_slicer<RATE>::ms_ppm_slicer(int channel_rate) :
+    d_rate(channel_rate)
+{
+}
+
+template <int RATE>
+template <typename T>
+int ms_ppm_slicer<RATE>::slice(const T *data_in, const ms_plinfo *attrib_in, int i, int end, int data_end,
+                               typename ms_sample_traits<T>::level reference, ms_frame_raw &frame,
+                               int &bit_index, int &frame_end) const
+{
+	typedef ms_sample_traits<T> traits;
+	int k;
+	typename traits::level f;
+	typename traits::level high_limit = traits::upper_reference_limit(reference, ms_db_plus_3);
+	typename traits::level low_limit = traits::lower_reference_limit(reference, ms_db_minus_3);
+	typename traits::level low_energy_limit = traits::lower_reference_limit(reference, ms_db_minus_6);
+	bit_index = 0;
+	frame_end = 0;
+	int multiplier = 1;
+	int phase = 0;  // Data bit phase
+	int chip_zero_ok = 0;
+	int chip_zero_low_energy = 0;
+	int chip_one_ok = 0;
+	int chip_one_low_energy = 0;
+	int score_zero = 0;
+	int score_one = 0;
+	int score_low_energy;
+	// Go for up to the Maximum Frame length for the data bits
+	// It is possible that noise could skew the phase enough that the buffer runs out so test input size as well
+	for(bit_index = 0; (i < end) && (bit_index < MS_LONG_FRAME_LENGTH); i++)
+	{
+		// If leading edge is a sample time late resync
+		if((phase == 1) && attrib_in[i].leading_edge())
+		{
+			phase--;
+			chip_one_ok = 0;   // Might as well reset
+			chip_one_low_energy = 0;
+		}
+		// If leading edge is a sample time early resync
+		if((phase == (d_rate.chip_width-1)) && attrib_in[i].leading_edge())
+		{
+			phase++;
+		}
+		// If leading edge is a sample time late resync
+		if((phase == (d_rate.chip_width+1)) && attrib_in[i].leading_edge())
+		{
+			phase--;
+			chip_zero_ok = 0;  // Might as well reset
+			chip_zero_low_energy = 0;
+		}
+		// If leading edge is a sample time early resync
+		if((phase == (d_rate.bit_width-1)) && attrib_in[i].leading_edge())
+		{
+			phase++;
+		}
+		// the middle of the pulses have more weight than the edges
+		if((phase == 0) ||(phase == (d_rate.chip_width-1)) ||
+		   (phase == d_rate.chip_width) ||(phase >= (d_rate.bit_width-1)))
+			multiplier = 1;
+		else
+			multiplier = 2;
+		// Score the samples that represent a valid level and a low energy level
+		if(phase < d_rate.chip_width)   // the first chip represents a data value of one
+		{
+			f = data_in[i];
+			if(f >= low_limit && f <= high_limit)
+				chip_one_ok += multiplier;
+			else if(f < low_energy_limit)
+				chip_one_low_energy += multiplier;
+		}
+		else if(phase < d_rate.bit_width)  // the second chip represents a data value of zero
+		{
+			f = data_in[i];
+			if(f >= low_limit && f <= high_limit)
+				chip_zero_ok += multiplier;
+			else if(f < low_energy_limit)
+				chip_zero_low_energy += multiplier;
+		}
+		if(++phase >= d_rate.bit_width)
+		{
+			// Decide what the bit is.  Tie scores go to the zero
+			score_one = chip_one_ok - chip_zero_ok + chip_zero_low_energy - chip_one_low_energy;
+			score_zero = chip_zero_ok - chip_one_ok + chip_one_low_energy - chip_zero_low_energy;
+			score_low_energy = chip_one_low_energy + chip_zero_low_energy - chip_one_ok - chip_zero_ok;
+			k = abs(score_one - score_zero);
+			if(k > 2)  // Bit has high confidence
+			{
+				frame.set_bit_high_confidence(bit_index, (score_one > score_zero)?1:0);
+			}
+			else if(k > 0)  // Bit has a low confidence
+			{
+				frame.set_bit_low_confidence(bit_index, (score_one > score_zero)?1:0);
+			}
+			else if(chip_zero_low_energy >= 6)  // both chips are equal as k == 0
+			{
+				frame.set_bit_low_energy(bit_index, (score_one > score_zero)?1:0);
+			}
+			else
+			{
+				frame.set_bit_low_confidence(bit_index, 0);
+			}
+			if(frame_end)
+				break;  // Frame done
+			phase = 0;
+			chip_zero_ok = 0;
+			chip_zero_low_energy = 0;
+			chip_one_ok = 0;
+			chip_one_low_energy = 0;
+			score_zero = 0;
+			score_one = 0;
+			bit_index++;
+		}
+		if(i == data_end)
+		{
+			if(phase == 0)
+				break;  // Frame done
+			else  // complete the bit
+				frame_end++;
+		}
+	}
+	return i;
+}
+
+#define MS_PPM_SLICER_INSTANTIATE(RATE) \
+    template class ms_ppm_slicer<RATE>; \
+    template int ms_ppm_slicer<RATE>::slice<float>(const float *, const ms_plinfo *, int, int, int, \
+                                                   float, ms_frame_raw &, int &, int &) const; \
+    template int ms_ppm_slicer<RATE>::slice<unsigned short>(const unsigned short *, const ms_plinfo *, int, int, int, \
+                                                            unsigned int, ms_frame_raw &, int &, int &) const;
+
+MS_FOR_EACH_RATE(MS_PPM_SLICER_INSTANTIATE)
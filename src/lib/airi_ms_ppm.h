@@ -0,0 +1,58 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_PPM_H
+#define INCLUDED_AIRI_MS_PPM_H
+
+#include <airi_ms_sample.h>
+#include <airi_ms_rate.h>
+
+class ms_plinfo;
+class ms_frame_raw;
+
+/*
+ * Mode S Pulse Position Modulation bit slicer shared by the decoder blocks
+ *
+ * Each chip is scored against the reference level and the bit goes to the
+ * chip with the better score.  Leading edges a sample early or late resync the
+ * bit phase.  The samples are float or unsigned short, see airi_ms_sample.h,
+ * and the slicer is built for the channel rates in airi_ms_rate.h.
+ */
+template <int RATE>
+class ms_ppm_slicer
+{
+public:
+    ms_ppm_slicer(int channel_rate);
+
+    // Slice the bits of a frame with data starting at i into frame
+    // Stops at a bit boundary at data_end, after MS_LONG_FRAME_LENGTH bits or at end
+    // Returns the sample it stopped at, bit_index is the number of bits sliced and
+    // frame_end is set if the frame ended in the middle of a bit
+    template <typename T>
+    int slice(const T *data_in, const ms_plinfo *attrib_in, int i, int end, int data_end,
+              typename ms_sample_traits<T>::level reference, ms_frame_raw &frame,
+              int &bit_index, int &frame_end) const;
+
+private:
+    ms_rate<RATE> d_rate;  // Chip and bit widths
+};
+
+#endif /* INCLUDED_AIRI_MS_PPM_H */
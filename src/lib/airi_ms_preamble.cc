@@ -0,0 +1,496 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <air_ms_types.h>
+#include <airi_ms_attrib.h>
+#include <airi_ms_preamble.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MS_HAVE_AVX2_KERNEL 1
+#endif
+
+template <int RATE>
+ms_preamble_detector<RATE>::ms_preamble_detector(int channel_rate, bool prefilter) :
+    d_rate(channel_rate)
+{
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	d_bit_positions[j] = d_rate.pulse(j);
+    d_check_width = MS_RATE_SAMPLES(MS_PREAMBLE_TIME_US+(5*MS_BIT_TIME_US), 1000000, channel_rate)+2;
+    d_last_edge = d_bit_positions[MS_PREAMBLE_PULSE_COUNT-1] + 1;
+    d_prefilter = prefilter;
+    d_next_edge = 0;
+    d_size = 0;
+    d_candidates = 0;
+    d_survivors = 0;
+}
+
+template <int RATE>
+void ms_preamble_detector<RATE>::scan(const ms_plinfo *attrib, int size)
+{
+    // A preamble has leading edges in at least two of its pulses so only
+    // the samples up to d_last_edge before a leading edge need to be checked
+    d_edges.clear();
+    ms_find_leading_edges(attrib, 0, size + d_last_edge, d_edges);
+    d_next_edge = 0;
+    d_size = size;
+}
+
+/*
+ * First stage for the offsets i to i+n-1 (n at most 32)
+ *
+ * Bit k of the result is set if offset i+k has a valid pulse at or one sample
+ * after each preamble pulse position and a leading edge at two or more of them.
+ * The pulse detector only marks leading edges on valid pulses.
+ * The scalar version is the reference for the vector kernels.
+ */
+static unsigned int ms_prefilter_generic(const ms_plinfo *attrib, const int *bits, int i, int n)
+{
+    unsigned int mask = 0;
+    for (int k = 0; k < n; k++)
+    {
+	int pulses = 0;
+	int edges = 0;
+	for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	{
+		unsigned int f = attrib[i+k+bits[j]].flags() | attrib[i+k+bits[j]+1].flags();
+		if(f & ms_plinfo::fl_valid_pulse)
+			pulses++;
+		if(f & ms_plinfo::fl_leading_edge)
+			edges++;
+	}
+	if((pulses == MS_PREAMBLE_PULSE_COUNT) && (edges >= (MS_PREAMBLE_PULSE_COUNT/2)))
+		mask |= 1u << k;
+    }
+    return mask;
+}
+
+#if defined(__SSE2__)
+// 16 offsets from i
+static unsigned int ms_prefilter_sse2(const ms_plinfo *attrib, const int *bits, int i)
+{
+    const char *p = (const char *)(attrib + i);
+    __m128i s[MS_PREAMBLE_PULSE_COUNT];
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	s[j] = _mm_or_si128(_mm_loadu_si128((const __m128i *)(p + bits[j])),
+	                    _mm_loadu_si128((const __m128i *)(p + bits[j] + 1)));
+    // A valid pulse in every slot
+    __m128i pulses = _mm_and_si128(_mm_and_si128(s[0], s[1]), _mm_and_si128(s[2], s[3]));
+    // A leading edge in at least two slots
+    __m128i edges = _mm_or_si128(_mm_or_si128(_mm_and_si128(s[0], _mm_or_si128(s[1], _mm_or_si128(s[2], s[3]))),
+                                              _mm_and_si128(s[1], _mm_or_si128(s[2], s[3]))),
+                                 _mm_and_si128(s[2], s[3]));
+    __m128i vp = _mm_set1_epi8(ms_plinfo::fl_valid_pulse);
+    __m128i le = _mm_set1_epi8(ms_plinfo::fl_leading_edge);
+    __m128i ok = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(pulses, vp), vp),
+                               _mm_cmpeq_epi8(_mm_and_si128(edges, le), le));
+    return _mm_movemask_epi8(ok);
+}
+#endif
+
+#if defined(MS_HAVE_AVX2_KERNEL)
+// 32 offsets from i
+__attribute__((target("avx2")))
+static unsigned int ms_prefilter_avx2(const ms_plinfo *attrib, const int *bits, int i)
+{
+    const char *p = (const char *)(attrib + i);
+    __m256i s[MS_PREAMBLE_PULSE_COUNT];
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	s[j] = _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(p + bits[j])),
+	                       _mm256_loadu_si256((const __m256i *)(p + bits[j] + 1)));
+    __m256i pulses = _mm256_and_si256(_mm256_and_si256(s[0], s[1]), _mm256_and_si256(s[2], s[3]));
+    __m256i edges = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(s[0], _mm256_or_si256(s[1], _mm256_or_si256(s[2], s[3]))),
+                                                    _mm256_and_si256(s[1], _mm256_or_si256(s[2], s[3]))),
+                                    _mm256_and_si256(s[2], s[3]));
+    __m256i vp = _mm256_set1_epi8(ms_plinfo::fl_valid_pulse);
+    __m256i le = _mm256_set1_epi8(ms_plinfo::fl_leading_edge);
+    __m256i ok = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(pulses, vp), vp),
+                                  _mm256_cmpeq_epi8(_mm256_and_si256(edges, le), le));
+    return _mm256_movemask_epi8(ok);
+}
+#endif
+
+// First stage for offsets i to i+n-1, the attributes must be readable up to i+n-1+d_last_edge
+template <int RATE>
+unsigned int ms_preamble_detector<RATE>::prefilter(const ms_plinfo *attrib, int i, int n) const
+{
+    unsigned int mask;
+#if defined(MS_HAVE_AVX2_KERNEL)
+    static const bool have_avx2 = __builtin_cpu_supports("avx2");
+    if(have_avx2 && (n == 32))
+	return ms_prefilter_avx2(attrib, d_bit_positions, i);
+#endif
+#if defined(__SSE2__)
+    if(n > 16)
+    {
+	mask = ms_prefilter_sse2(attrib, d_bit_positions, i);
+	return mask | (ms_prefilter_sse2(attrib, d_bit_positions, i + 16) << 16);
+    }
+    if(n == 16)
+	return ms_prefilter_sse2(attrib, d_bit_positions, i);
+#endif
+    mask = ms_prefilter_generic(attrib, d_bit_positions, i, n);
+    return mask;
+}
+
+template <int RATE>
+template <typename T>
+int ms_preamble_detector<RATE>::find(const T *data, const ms_plinfo *attrib, int i, int size,
+                                     typename ms_sample_traits<T>::level &reference)
+{
+    while(i < size)
+    {
+	while((d_next_edge < d_edges.size()) && (d_edges[d_next_edge] < i))
+		d_next_edge++;
+	if(d_next_edge == d_edges.size())
+		return size;  // No more leading edges
+	int edge = d_edges[d_next_edge];
+	if(edge - d_last_edge > i)
+		i = edge - d_last_edge; // Skip to the window of the next leading edge
+	int end = (edge < size) ? edge + 1 : size;
+	while(i < end)
+	{
+		int n = end - i;
+		if(n > 32)
+			n = 32;
+		d_candidates += n;
+		unsigned int mask;
+		if(!d_prefilter)
+			mask = (n == 32) ? 0xffffffff : ((1u << n) - 1);
+		else if((n < 32) && (i + 32 + d_last_edge <= d_size + d_check_width))
+			mask = prefilter(attrib, i, 32) & ((1u << n) - 1);  // Whole vector is readable
+		else
+			mask = prefilter(attrib, i, n);
+		while(mask)
+		{
+			int k = __builtin_ctz(mask);
+			mask &= mask - 1;
+			d_survivors++;
+			if(check(data, attrib, i + k, reference))
+				return i + k;
+		}
+		i += n;
+	}
+    }
+    return size;
+}
+
+template <int RATE>
+template <typename T>
+bool ms_preamble_detector<RATE>::check(const T *data_in, const ms_plinfo *attrib_in, int i,
+                                       typename ms_sample_traits<T>::level &reference_out) const
+{
+    typedef ms_sample_traits<T> traits;
+    typedef typename traits::level level;
+    int j, k;
+    level f;
+	level reference = 0;
+    	int   lateness[MS_PREAMBLE_PULSE_COUNT];  // How late a bit is in samples
+    	int   pcount = 0;
+    	int   lcount = 0;
+        int maxcount = 0;
+        int multiflag = 0;
+    	level levels[d_rate.var_n*MS_PREAMBLE_PULSE_COUNT];
+        int rcount[d_rate.var_n*MS_PREAMBLE_PULSE_COUNT];
+        level high_limit = 0;
+        level low_limit = 0;
+        level min_level = 0;
+        level max_level = 0;
+        for (j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+		lateness[j] = -1;
+	// look for valid pulses at 0 1 3.5 and 4.5 uS
+        // also collect samples for later processing
+	for(j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	{
+		int pos = i + d_rate.pulse(j); // Position to the sample
+		if(attrib_in[pos+1].leading_edge())
+		{
+			lateness[j] = 1;
+			for(k = 1; k <= d_rate.var_n; k++)
+				levels[lcount++] = data_in[pos+k+lateness[j]];
+    			pcount++;
+		}
+		else if(attrib_in[pos].leading_edge())
+		{
+			lateness[j] = 0;
+			for(k = 1; k <= d_rate.var_n; k++)
+				levels[lcount++] = data_in[pos+k+lateness[j]];
+    			pcount++;
+		}
+		else if(attrib_in[pos].valid_pulse())
+		{
+			lateness[j] = 0;
+    			pcount++;
+		}
+		else if(attrib_in[pos+1].valid_pulse())
+		{
+			lateness[j] = 1;
+    			pcount++;
+		}
+		else
+			break;  // No Valid Pulse in time slot
+	}
+	if((pcount < MS_PREAMBLE_PULSE_COUNT) || (lcount < (d_rate.var_n*(MS_PREAMBLE_PULSE_COUNT/2))))
+		return false;
+        // Plus or minus one sample is okay but not samples at both plus and minus
+        // This code only looks ahead one sample so it is possible that all four samples are late
+        // If all samples are late then just continue and it will be picked up next time
+	if((lateness[0] + lateness[1] + lateness[2] + lateness[3]) == 4)
+		return false;
+        // The Mode S specifications say the amplitude levels of the pulses must be within 2 dB
+	// Take the samples after the leading edges and figure out the reference level
+        // The Reference Level is also used downstream for framing and decoding
+        multiflag = 0;
+	for(j = 0; j < lcount; j++)
+	{
+		// Count the number of other samples that are within 2 db of the level
+		rcount[j] = 0;
+		high_limit = traits::upper_limit(levels[j], ms_db_plus_2);  // 2 db
+		low_limit = traits::lower_limit(levels[j], ms_db_minus_2);  // - 2 db
+		for(k = 0; k < lcount; k++)
+		{
+			if(j == k) // Do not count itself
+				continue;
+			if(levels[k] >= low_limit && levels[k] <= high_limit)
+				rcount[j]++;
+		}
+                // if the count is the higher than previous high level then assume it is the only highest
+		if(rcount[j] > maxcount)
+		{
+			maxcount = rcount[j];
+			multiflag = 0;
+                        // This is the reference candidate
+			min_level = levels[j];
+			reference = traits::to_reference(levels[j]);
+		}
+                // else if there is a tie more processing is needed unless a higher level comes along later
+		else if(rcount[j] == maxcount)
+		{
+			multiflag++;
+                        // find the minimum power of the maximum count samples
+			if(levels[j] < min_level)
+			{
+				min_level = levels[j];
+			}
+		}
+	}
+        // If there are 2 or more values with the same maximum count then average out the samples
+	if(multiflag)
+	{
+		max_level = traits::upper_limit(min_level, ms_db_plus_2); // + 2 dB
+		reference = 0;
+		k = 0;
+		for(j = 0; j < lcount; j++)
+		{
+			// Sum up samples with the maximum count and within 2 dB of minimum power
+			if((rcount[j] == maxcount) && (levels[j] <= max_level))
+			{
+				reference += levels[j];
+				k++;
+			}
+		}
+                // This should never happen so if it does then give up
+		if ((k == 0) || (reference == 0))
+			return false;
+                // Average the samples
+		reference = traits::average_reference(reference, k);
+	}
+        // Mode S Frames can overlap (FRUIT) and if the later frame is 3 dB or stronger it can be decoded.
+        // Later processing can retrigger the start of a data frame but it has problems when
+        // the later preamble values are used to calculate the current preamble reference level.
+        //
+        // Look for overlapping preambles
+        // Only the bit after the preamble start + the bit time is used
+        // Start with the 1.0 uS position and find the minimum level at 1.0 2.0 4.5 5.5
+        int offset = i + lateness[0] + d_rate.pulse(1) + 1;
+        min_level = data_in[offset + d_rate.pulse(0)];
+        for (j = 1; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	{
+		f = data_in[offset+d_rate.pulse(j)];
+		if(f < min_level)
+			min_level = f;
+	}
+        // calculate the -3 dB point
+        min_level = traits::lower_limit(min_level, ms_db_minus_3);  // -3 dB
+        // Find maximum of 0 and 3.5
+	offset = i + lateness[0] + 1;
+	max_level = data_in[offset + d_rate.pulse(0)];
+        f =  data_in[offset + d_rate.pulse(2)];
+	if(f > max_level)
+		max_level = f;
+        // If maximum of 0 and 3.5 is below the -3 dB point of the minimum level at 1.0 2.0 4.5 5.5 then reject
+	if(max_level < min_level)
+		return false;
+        // Go to the 3.5 position and find the minimum level at 3.5 4.5 7.0 8.0
+        offset = i + lateness[0] + d_rate.pulse(2) + 1;
+        min_level = data_in[offset + d_rate.pulse(0)];
+        for(j = 1; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	{
+		f = data_in[offset+d_rate.pulse(j)];
+		if(f < min_level)
+			min_level = f;
+	}
+       // calculate the -3 dB point
+        min_level = traits::lower_limit(min_level, ms_db_minus_3);  // - 3 dB
+        // Find maximum of 0 and 1.0
+	offset = i + lateness[0] + 1;
+	max_level = data_in[offset + d_rate.pulse(0)];
+        f =  data_in[offset + d_rate.pulse(1)];
+	if(f > max_level)
+		max_level = f;
+        // If maximum of 0 and 1.0 is below the -3 dB point of the minimum level at 3.5 4.5 7.0 8.0 then reject
+	if(max_level < min_level)
+		return false;
+        // Go to the 4.5 position and find the minimum level at 4.5 5.5 8.0 9.0
+        offset = i + lateness[0] + d_rate.pulse(3) + 1;
+        min_level = data_in[offset + d_rate.pulse(0)];
+        for(j = 1; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	{
+		f = data_in[offset+d_rate.pulse(j)];
+		if(f < min_level)
+			min_level = f;
+	}
+       // calculate the -3 dB point
+        min_level = traits::lower_limit(min_level, ms_db_minus_3);  // -3 dB
+       // Find maximum of 0 1.0 3.5
+	offset = i + lateness[0] + 1;
+	max_level = data_in[offset + d_rate.pulse(0)];
+        f =  data_in[offset + d_rate.pulse(1)];
+	if(f > max_level)
+		max_level = f;
+        f =  data_in[offset + d_rate.pulse(2)];
+	if(f > max_level)
+		max_level = f;
+        // If maximum of 0 1.0 3.5 is below the -3 dB point of the minimum level at 4.5 5.5 8.0 9.0 then reject
+	if(max_level < min_level)
+		return false;
+	// Consistent Power Test
+        // Two out of the 4 preambles must be within 3 dB of the reference
+	maxcount = 0;
+	high_limit = traits::upper_reference_limit(reference, ms_db_plus_3);  // + 3 dB
+	low_limit = traits::lower_reference_limit(reference, ms_db_minus_3);  // - 3 dB
+	offset = i + lateness[0] + 1;
+        for(j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+	{
+		f = data_in[offset+d_rate.pulse(j)];
+		if (f >= low_limit && f <= high_limit)
+			maxcount++;
+	}
+	if(maxcount < (MS_PREAMBLE_PULSE_COUNT/2))
+		return false;  // No preamble here so return
+        // DF Validation
+        // Look for valid pulses in one or both of the chip positions for 5 data bits
+        // Pulses must be -6 dB or greater of the reference level
+        low_limit = traits::lower_reference_limit(reference, ms_db_minus_6);  // -6 dB
+        offset = i + lateness[0] + d_rate.data_start;
+	for( j = 0; j < (5 * d_rate.bit_width); j += d_rate.bit_width)
+	{
+		int chips;
+		int leflag;
+                int jj;
+		max_level = 0;
+		chips = 0;
+		leflag = 0;
+		k = 0;
+		if(attrib_in[offset+j].valid_pulse())
+		{
+			chips++;
+			max_level = data_in[offset+j]; // init maximum level
+			leflag = 1;
+		}
+		else // look at +/- 1 bit for valid pulse
+		{
+			for(k = -1; k < 2; k += 2)
+			{
+				if(attrib_in[offset+j+k].valid_pulse())
+				{
+					chips++;
+					max_level = data_in[offset+j+k]; // init maximum level
+					leflag = 1;
+					break;
+				}
+			}
+                }
+		if(leflag)
+		{
+			for(jj = 0; jj < d_rate.var_m; jj++)
+			{
+				if(data_in[offset+j+k+jj] > max_level)
+					max_level = data_in[offset+j+k+jj];
+			}
+		}
+                // Look at the second chip now
+		leflag = 0;
+                k = d_rate.chip_width;
+		if(attrib_in[offset+j+k].valid_pulse())
+		{
+			chips++;
+			max_level = data_in[offset+j+k]; // init maximum level
+			leflag = 1;
+		}
+		else // look at +/- 1 bit for valid pulse
+		{
+			for(k = d_rate.chip_width -1; k < d_rate.chip_width+2; k += 2)
+			{
+				if(attrib_in[offset+j+k].valid_pulse())
+				{
+					chips++;
+					max_level = data_in[offset+j+k];
+					leflag = 1;
+					break;
+				}
+			}
+		}
+		if(leflag)
+		{
+			for(jj = 0; jj < d_rate.var_m; jj++)
+			{
+				if(data_in[offset+j+k+jj] > max_level)
+					max_level = data_in[offset+j+k+jj];
+			}
+		}
+		if ((chips == 0) || (max_level < low_limit))
+			break;  // No preamble here so break out
+	}
+	if(j < (5 * d_rate.bit_width)) // If Data Field is not valid then search
+		return false;
+	// There is a possible preamble
+	reference_out = reference;
+	return true;
+}
+
+#define MS_PREAMBLE_DETECTOR_INSTANTIATE(RATE) \
+    template class ms_preamble_detector<RATE>; \
+    template int ms_preamble_detector<RATE>::find<float>(const float *, const ms_plinfo *, int, int, float &); \
+    template int ms_preamble_detector<RATE>::find<unsigned short>(const unsigned short *, const ms_plinfo *, \
+                                                                  int, int, unsigned int &); \
+    template bool ms_preamble_detector<RATE>::check<float>(const float *, const ms_plinfo *, int, float &) const; \
+    template bool ms_preamble_detector<RATE>::check<unsigned short>(const unsigned short *, const ms_plinfo *, \
+                                                                    int, unsigned int &) const;
+
+MS_FOR_EACH_RATE(MS_PREAMBLE_DETECTOR_INSTANTIATE)
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_PREAMBLE_H
+#define INCLUDED_AIRI_MS_PREAMBLE_H
+
+#include <vector>
+#include <air_ms_consts.h>   // For Mode S const values
+#include <airi_ms_sample.h>
+#include <airi_ms_rate.h>
+
+class ms_plinfo;
+
+/*
+ * Mode S preamble detection shared by the demodulator blocks
+ *
+ * The search runs in two stages.  The first stage correlates the pulse
+ * attributes with the four pulse preamble template for 16 (SSE2) or 32 (AVX2)
+ * offsets at once.  It keeps the offsets with a valid pulse in every preamble
+ * slot and a leading edge in at least two, which the exact checks need anyway.
+ * The second stage is the exact reference level, overlapping preamble, power
+ * and DF checks and runs only on the survivors.  The samples are float or
+ * unsigned short, see airi_ms_sample.h, and the detector is built for the
+ * channel rates in airi_ms_rate.h.
+ */
+template <int RATE>
+class ms_preamble_detector
+{
+public:
+    ms_preamble_detector(int channel_rate, bool prefilter = true);
+
+    // Index the leading edges of a buffer so preambles in [0, size) can be found
+    void scan(const ms_plinfo *attrib, int size);
+    // Next preamble start at or after i, size if there is none
+    // Successive calls must not go backwards
+    template <typename T>
+    int find(const T *data, const ms_plinfo *attrib, int i, int size,
+             typename ms_sample_traits<T>::level &reference);
+    // Exact checks for a preamble starting at i
+    template <typename T>
+    bool check(const T *data, const ms_plinfo *attrib, int i,
+               typename ms_sample_traits<T>::level &reference) const;
+
+    // Samples needed after a preamble start
+    int check_width() const { return d_check_width; }
+
+    // Counters
+    unsigned long candidates() const { return d_candidates; }  // Offsets tested by the first stage
+    unsigned long survivors() const { return d_survivors; }    // Offsets given the exact checks
+
+private:
+    unsigned int prefilter(const ms_plinfo *attrib, int i, int n) const;
+
+    ms_rate<RATE> d_rate;  // Sample positions and widths
+    int d_bit_positions[MS_PREAMBLE_PULSE_COUNT];  // Position of preample pulses for the first stage
+    int d_check_width;   // Width of Preamble checking in samples
+    int d_last_edge;     // Latest a leading edge can be after the preamble start
+    bool d_prefilter;    // Use the first stage
+    std::vector<int> d_edges;  // Leading edges of the current buffer
+    unsigned int d_next_edge;  // First edge not behind the search
+    int d_size;                // Preambles are searched for in [0, d_size)
+    unsigned long d_candidates;
+    unsigned long d_survivors;
+};
+
+#endif /* INCLUDED_AIRI_MS_PREAMBLE_H */
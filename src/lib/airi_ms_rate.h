@@ -0,0 +1,114 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_RATE_H
+#define INCLUDED_AIRI_MS_RATE_H
+
+#include <stdint.h>
+#include <air_ms_consts.h>   // For Mode S const values
+
+/*
+ * Sample geometry of a channel rate
+ *
+ * The demodulator kernels are templates on the channel rate.  ms_rate<RATE>
+ * has the sample positions and widths for RATE as compile time constants so
+ * the kernels built for it test fixed offsets and unroll their loops.
+ * ms_rate<MS_RATE_RUNTIME> has the same members worked out for the rate it is
+ * made with, for the rates there is no build for.  The builds are listed in
+ * MS_FOR_EACH_RATE and ms_rate_is_built() tells a rate has one.
+ */
+const int MS_RATE_RUNTIME = 0;
+
+#define MS_FOR_EACH_RATE(X) \
+    X(MS_RATE_RUNTIME) X(8000000) X(10000000) X(16000000) X(20000000)
+
+inline bool ms_rate_is_built(int channel_rate)
+{
+    return (channel_rate == 8000000) || (channel_rate == 10000000) ||
+           (channel_rate == 16000000) || (channel_rate == 20000000);
+}
+
+// Samples in n units of time where a second is d units, in 64 bits as 120 uS at 20 Msps overflows
+#define MS_RATE_SAMPLES(n, d, rate) ((int)((int64_t)(n) * (rate) / (d)))
+
+// Preamble pulse starts in 0.1 uS units
+static const int ms_preamble_pulse_starts[MS_PREAMBLE_PULSE_COUNT] = { 0, 10, 35, 45 };
+
+template <int RATE>
+struct ms_rate
+{
+    ms_rate(int) {}
+
+    static const int bit_width = MS_RATE_SAMPLES(MS_BIT_TIME_US, 1000000, RATE);  // Width of bit in samples
+    static const int chip_width = bit_width / 2;   // Two Chips per bit
+    static const int data_start = MS_RATE_SAMPLES(MS_PREAMBLE_TIME_US, 1000000, RATE);  // When the data starts
+    static const int var_n = (RATE > 8000000) ? 3 : 2;  // Number of samples to use after a leading edge
+    static const int var_m = var_n + 1;  // var_n plus trailing edge
+    static const int min_frame_width = MS_RATE_SAMPLES(MS_PREAMBLE_TIME_US + MS_BIT_TIME_US * MS_SHORT_FRAME_LENGTH, 1000000, RATE);
+    static const int max_frame_width = MS_RATE_SAMPLES(MS_PREAMBLE_TIME_US + MS_BIT_TIME_US * MS_LONG_FRAME_LENGTH, 1000000, RATE);
+
+    // Start of preamble pulse j in samples
+    static int pulse(int j) { return MS_RATE_SAMPLES(ms_preamble_pulse_starts[j], 10000000, RATE); }
+    int rate() const { return RATE; }
+};
+
+template <int RATE> const int ms_rate<RATE>::bit_width;
+template <int RATE> const int ms_rate<RATE>::chip_width;
+template <int RATE> const int ms_rate<RATE>::data_start;
+template <int RATE> const int ms_rate<RATE>::var_n;
+template <int RATE> const int ms_rate<RATE>::var_m;
+template <int RATE> const int ms_rate<RATE>::min_frame_width;
+template <int RATE> const int ms_rate<RATE>::max_frame_width;
+
+template <>
+struct ms_rate<MS_RATE_RUNTIME>
+{
+    ms_rate(int channel_rate) :
+	bit_width(MS_RATE_SAMPLES(MS_BIT_TIME_US, 1000000, channel_rate)),
+	chip_width(bit_width / 2),
+	data_start(MS_RATE_SAMPLES(MS_PREAMBLE_TIME_US, 1000000, channel_rate)),
+	var_n((channel_rate > 8000000) ? 3 : 2),
+	var_m(var_n + 1),
+	min_frame_width(MS_RATE_SAMPLES(MS_PREAMBLE_TIME_US + MS_BIT_TIME_US * MS_SHORT_FRAME_LENGTH, 1000000, channel_rate)),
+	max_frame_width(MS_RATE_SAMPLES(MS_PREAMBLE_TIME_US + MS_BIT_TIME_US * MS_LONG_FRAME_LENGTH, 1000000, channel_rate)),
+	d_channel_rate(channel_rate)
+    {
+	for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+		d_pulses[j] = MS_RATE_SAMPLES(ms_preamble_pulse_starts[j], 10000000, channel_rate);
+    }
+
+    const int bit_width;
+    const int chip_width;
+    const int data_start;
+    const int var_n;
+    const int var_m;
+    const int min_frame_width;
+    const int max_frame_width;
+
+    int pulse(int j) const { return d_pulses[j]; }
+    int rate() const { return d_channel_rate; }
+
+private:
+    int d_channel_rate;
+    int d_pulses[MS_PREAMBLE_PULSE_COUNT];
+};
+
+#endif /* INCLUDED_AIRI_MS_RATE_H */
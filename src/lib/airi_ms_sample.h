@@ -0,0 +1,116 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_SAMPLE_H
+#define INCLUDED_AIRI_MS_SAMPLE_H
+
+#include <stdint.h>
+
+/*
+ * Sample types of the demodulator kernels
+ *
+ * The kernels take the magnitude either as float or as unsigned short, fixed
+ * point in units the pulse detector chose.  A level is the type sums of and
+ * limits on the samples are kept in.  The kernels test levels against a level
+ * times a dB ratio, which for fixed point samples is a 64 bit multiply by the
+ * ratio in 2^-24ths and a shift.
+ *
+ * A limit is either an upper limit, a level passes if it is at most the
+ * limit, or a lower limit, a level passes if it is at least the limit.  For
+ * fixed point samples an upper limit is rounded down and a lower limit up, so
+ * a whole number level passes exactly when it would against the unrounded
+ * limit.  Rounding to nearest passed or failed levels within half a unit of
+ * the limit that the float kernels did not.  The fixed point kernels still
+ * differ from the float ones by the rounding of the samples to whole units.
+ *
+ * A reference is the level of a preamble, which may be the average of up to
+ * twelve levels.  The fixed point kernels keep it in 1/27720ths of a unit,
+ * which every count up to twelve divides, so the average and the limits on it
+ * are exact too.  Limits on a reference in those units, as the retrigger test
+ * compares references, use upper_limit and lower_limit; limits on samples use
+ * the reference limits.
+ */
+struct ms_db_ratio
+{
+    double f;        // Ratio
+    unsigned int q;  // Ratio times 2^24, rounded
+};
+
+static const ms_db_ratio ms_db_plus_2 = { 1.25893, 21121341 };
+static const ms_db_ratio ms_db_minus_2 = { 0.79433, 13326646 };
+static const ms_db_ratio ms_db_plus_3 = { 1.41253, 23698321 };
+static const ms_db_ratio ms_db_minus_3 = { 0.70795, 11877430 };
+static const ms_db_ratio ms_db_minus_6 = { 0.5012, 8408741 };
+
+// Ratio of a float, such as a pulse detector attack constant
+inline ms_db_ratio ms_make_db_ratio(float ratio)
+{
+    ms_db_ratio r;
+    r.f = ratio;
+    r.q = (unsigned int)(ratio * 16777216.0 + 0.5);
+    return r;
+}
+
+template <typename T> struct ms_sample_traits;
+
+template <> struct ms_sample_traits<float>
+{
+    typedef float level;
+    // Rounded to float as the limits always were
+    static float upper_limit(float x, const ms_db_ratio &r) { return x * r.f; }
+    static float lower_limit(float x, const ms_db_ratio &r) { return x * r.f; }
+    static float to_reference(float x) { return x; }
+    static float average_reference(float sum, int n) { return sum / (float)n; }
+    static float reference_level(float ref) { return ref; }
+    static float upper_reference_limit(float ref, const ms_db_ratio &r) { return ref * r.f; }
+    static float lower_reference_limit(float ref, const ms_db_ratio &r) { return ref * r.f; }
+};
+
+template <> struct ms_sample_traits<unsigned short>
+{
+    typedef unsigned int level;
+    static unsigned int upper_limit(unsigned int x, const ms_db_ratio &r)
+    {
+	return (unsigned int)(((uint64_t)x * r.q) >> 24);
+    }
+    static unsigned int lower_limit(unsigned int x, const ms_db_ratio &r)
+    {
+	return (unsigned int)(((uint64_t)x * r.q + (1u << 24) - 1) >> 24);
+    }
+    static const unsigned int reference_units = 27720;  // Least common multiple of 1 to 12
+    static unsigned int to_reference(unsigned int x) { return x * reference_units; }
+    static unsigned int average_reference(unsigned int sum, int n)
+    {
+	return (unsigned int)((uint64_t)sum * reference_units / n);
+    }
+    static float reference_level(unsigned int ref) { return ref / (float)reference_units; }
+    static unsigned int upper_reference_limit(unsigned int ref, const ms_db_ratio &r)
+    {
+	return (unsigned int)(((uint64_t)ref * r.q) / ((uint64_t)reference_units << 24));
+    }
+    static unsigned int lower_reference_limit(unsigned int ref, const ms_db_ratio &r)
+    {
+	uint64_t units = (uint64_t)reference_units << 24;
+	return (unsigned int)(((uint64_t)ref * r.q + units - 1) / units);
+    }
+};
+
+#endif /* INCLUDED_AIRI_MS_SAMPLE_H */
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <airi_ms_syndrome.h>
+#include <airi_ms_parity.h>
+
+// Marks a syndrome given by more than one error pattern
+static const short MS_SYNDROME_AMBIGUOUS = -2;
+
+ms_syndrome_table::ms_syndrome_table(int length) :
+    d_length(length)
+{
+    // At least twice as many slots as one and two bit errors
+    int errors = length + length * (length - 1) / 2;
+    int bits = 1;
+    while((1 << bits) < 2 * errors)
+	bits++;
+    d_shift = 32 - bits;
+    entry empty = {0, -1, -1};
+    d_entries.assign(1 << bits, empty);
+
+    // Offset into the parity table for short frames
+    int offset = MS_LONG_FRAME_LENGTH - length;
+    for(int p = 0; p < length; p++)
+    {
+	insert(ms_parity_table[p + offset], p, -1);
+	for(int q = p + 1; q < length; q++)
+		insert(ms_parity_table[p + offset] ^ ms_parity_table[q + offset], p, q);
+    }
+}
+
+void ms_syndrome_table::insert(unsigned int syndrome, int first, int second)
+{
+    unsigned int mask = d_entries.size() - 1;
+    for(unsigned int s = slot(syndrome); ; s = (s + 1) & mask)
+    {
+	entry &e = d_entries[s];
+	if(e.first == -1)
+	{
+		e.syndrome = syndrome;
+		e.first = first;
+		e.second = second;
+		return;
+	}
+	if(e.syndrome == syndrome)
+	{
+		e.first = MS_SYNDROME_AMBIGUOUS;
+		return;
+	}
+    }
+}
+
+int ms_syndrome_table::lookup(unsigned int syndrome, int positions[2]) const
+{
+    unsigned int mask = d_entries.size() - 1;
+    for(unsigned int s = slot(syndrome); ; s = (s + 1) & mask)
+    {
+	const entry &e = d_entries[s];
+	if(e.first == -1)
+		return 0;
+	if(e.syndrome == syndrome)
+	{
+		if(e.first == MS_SYNDROME_AMBIGUOUS)
+			return 0;
+		positions[0] = e.first;
+		positions[1] = e.second;
+		return (e.second < 0) ? 1 : 2;
+	}
+    }
+}
+
+static const ms_syndrome_table ms_long_syndromes(MS_LONG_FRAME_LENGTH);
+static const ms_syndrome_table ms_short_syndromes(MS_SHORT_FRAME_LENGTH);
+
+const ms_syndrome_table &ms_syndromes(int length)
+{
+    return (length == MS_LONG_FRAME_LENGTH) ? ms_long_syndromes : ms_short_syndromes;
+}
+
+bool ms_syndromes_independent(const unsigned int *syndromes, int n)
+{
+    // Gaussian elimination over GF(2), one pivot per leading bit
+    unsigned int pivots[32] = {0};
+    for(int i = 0; i < n; i++)
+    {
+	unsigned int x = syndromes[i];
+	while(x)
+	{
+		int b = 31 - __builtin_clz(x);
+		if(!pivots[b])
+		{
+			pivots[b] = x;
+			break;
+		}
+		x ^= pivots[b];
+	}
+	if(!x)
+		return false;
+    }
+    return true;
+}
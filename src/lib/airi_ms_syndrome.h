@@ -0,0 +1,70 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_SYNDROME_H
+#define INCLUDED_AIRI_MS_SYNDROME_H
+
+#include <vector>
+#include <air_ms_consts.h>   // For Mode S const values
+
+/*
+ * Error syndromes of all one and two bit errors in a frame
+ *
+ * The table is an open addressed hash of syndrome to bit positions.  A
+ * syndrome that more than one error pattern gives is not found.
+ */
+class ms_syndrome_table
+{
+public:
+    ms_syndrome_table(int length);
+
+    // Bit positions of the one or two bit error with this syndrome
+    // Returns the number of bits in error, zero if it is not in the table
+    int lookup(unsigned int syndrome, int positions[2]) const;
+
+    int length() const { return d_length; }
+
+private:
+    struct entry
+    {
+	unsigned int syndrome;
+	short first;    // Bit positions, first is -1 for an empty entry
+	short second;   // and second is -1 for a one bit error
+    };
+
+    void insert(unsigned int syndrome, int first, int second);
+    unsigned int slot(unsigned int syndrome) const
+    {
+	return (syndrome * 0x9e3779b1u) >> d_shift;
+    }
+
+    int d_length;        // Frame length in bits
+    int d_shift;         // Hash shift for the table size
+    std::vector<entry> d_entries;
+};
+
+// Tables for both frame lengths, built once at startup
+const ms_syndrome_table &ms_syndromes(int length);
+
+// True if no XOR of a non empty subset of the n syndromes is zero
+bool ms_syndromes_independent(const unsigned int *syndromes, int n);
+
+#endif /* INCLUDED_AIRI_MS_SYNDROME_H */
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <airi_ms_toa.h>
+
+// Edges are looked for this many samples either side of where they should be
+const int MS_TOA_EDGE_SEARCH = 2;
+// Largest pulse offset believed, in samples
+const float MS_TOA_MAX_OFFSET = 2.0;
+
+ms_toa_estimator::ms_toa_estimator(int channel_rate)
+{
+    // Pulses at 0, 1.0, 3.5 and 4.5 uS, 0.5 uS wide
+    static const int starts[MS_PREAMBLE_PULSE_COUNT] = { 0, 10, 35, 45 };  // 0.1 us units
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+    {
+	d_bit_positions[j] = starts[j] * channel_rate / 10000000;
+	d_pulse_centres[j] = (starts[j] + 2.5) * channel_rate / 10000000.0;
+    }
+    d_chip_width = MS_BIT_TIME_US * channel_rate / 2000000;
+}
+
+// Centre of the pulse that should start at pos, relative to pos
+template <typename T>
+bool ms_toa_estimator::pulse_centre(const T *data, int pos, float threshold, float &centre) const
+{
+    int k, end;
+    float rise = 0.0, fall = 0.0;
+    // Leading edge, the first sample at or over the threshold after one under it
+    k = (pos - MS_TOA_EDGE_SEARCH > 1) ? pos - MS_TOA_EDGE_SEARCH : 1;
+    for (end = pos + MS_TOA_EDGE_SEARCH; k <= end; k++)
+	if((data[k-1] < threshold) && (data[k] >= threshold))
+		break;
+    if(k > end)
+	return false;
+    rise = (k - 1 - pos) + (threshold - data[k-1]) / (data[k] - data[k-1]);
+    // Trailing edge, the first sample under the threshold a pulse width later
+    for (k = k + d_chip_width - MS_TOA_EDGE_SEARCH, end = k + 2 * MS_TOA_EDGE_SEARCH; k <= end; k++)
+	if((data[k-1] >= threshold) && (data[k] < threshold))
+		break;
+    if(k > end)
+	return false;
+    fall = (k - 1 - pos) + (data[k-1] - threshold) / (data[k-1] - data[k]);
+    centre = (rise + fall) * 0.5f;
+    return true;
+}
+
+template <typename T>
+bool ms_toa_estimator::estimate(const T *data, int i, float reference, float &offset) const
+{
+    float threshold = reference * 0.5f;
+    float sum = 0.0;
+    int count = 0;
+    for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+    {
+	float centre;
+	if(!pulse_centre(data, i + d_bit_positions[j], threshold, centre))
+		continue;
+	float d = centre - (float)(d_pulse_centres[j] - d_bit_positions[j]);
+	if((d > MS_TOA_MAX_OFFSET) || (d < -MS_TOA_MAX_OFFSET))
+		continue;
+	sum += d;
+	count++;
+    }
+    if(count < 2)
+	return false;
+    offset = sum / count;
+    return true;
+}
+
+template bool ms_toa_estimator::estimate<float>(const float *, int, float, float &) const;
+template bool ms_toa_estimator::estimate<unsigned short>(const unsigned short *, int, float, float &) const;
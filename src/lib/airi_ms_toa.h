@@ -0,0 +1,59 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIRI_MS_TOA_H
+#define INCLUDED_AIRI_MS_TOA_H
+
+#include <air_ms_consts.h>   // For Mode S const values
+
+/*
+ * Time of arrival of a preamble to a fraction of a sample
+ *
+ * The preamble detector finds the preamble start to a whole sample.  The
+ * estimator finds where the leading and trailing edges of each preamble pulse
+ * cross half the reference level, interpolating between the samples on either
+ * side, and takes the centre of each pulse.  The offset of the preamble start
+ * is the mean of the pulse centres less their nominal positions.  Pulse
+ * centres do not depend on the rise time so the threshold does not bias the
+ * result.  Pulses without both edges near their nominal position, as when
+ * another frame overlaps, are left out.  The samples are float or unsigned
+ * short and the reference is in their units.
+ */
+class ms_toa_estimator
+{
+public:
+    ms_toa_estimator(int channel_rate);
+
+    // Arrival of the preamble found at sample i relative to i, in samples.
+    // False if fewer than two pulses have both edges.
+    template <typename T>
+    bool estimate(const T *data, int i, float reference, float &offset) const;
+
+private:
+    template <typename T>
+    bool pulse_centre(const T *data, int pos, float threshold, float &centre) const;
+
+    int d_bit_positions[MS_PREAMBLE_PULSE_COUNT];      // Pulse starts in whole samples
+    double d_pulse_centres[MS_PREAMBLE_PULSE_COUNT];   // Nominal pulse centres in samples
+    int d_chip_width;    // Width of a pulse in samples
+};
+
+#endif /* INCLUDED_AIRI_MS_TOA_H */
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Benchmark of the Mode S parity check
+ *
+ * Compares the byte table CRC-24 of ms_check_parity with the bit at a time
+ * loop over ms_parity_table it replaced, on random short and long frames.
+ *
+ * usage: benchmark_ms_parity [frames]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include <air_ms_types.h>
+#include <airi_ms_parity.h>
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// The bit at a time parity check
+static int bit_check_parity(const ms_frame_raw &frame)
+{
+	int short_crc, long_crc, i;
+	// Check both long and short
+	short_crc = 0;
+	long_crc = 0;
+	for(i = 0; i < MS_SHORT_FRAME_LENGTH; i++)
+	{
+		if(frame.bit(i))
+		{
+			short_crc ^= ms_parity_table[i+56];
+			long_crc ^= ms_parity_table[i];
+
+		}
+	}
+	for( ; i < frame.length(); i++)
+	{
+		if(frame.bit(i))
+		{
+			long_crc ^= ms_parity_table[i];
+		}
+	}
+	return ((frame.length() == MS_LONG_FRAME_LENGTH)?long_crc:short_crc);
+}
+
+int main(int argc, char **argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+    std::vector<ms_frame_raw> frames(n);
+    srand(1);
+    for (int i = 0; i < n; i++)
+    {
+	for (int j = 0; j < MS_LONG_FRAME_LENGTH; j++)
+		frames[i].set_bit_high_confidence(j, rand() & 1);
+	if(rand() & 1)
+		frames[i].set_long_frame();
+	else
+		frames[i].set_short_frame();
+    }
+
+    unsigned int bit_sum = 0;
+    double start = now();
+    for (int i = 0; i < n; i++)
+	bit_sum += bit_check_parity(frames[i]);
+    double bit_cpu = now() - start;
+
+    unsigned int table_sum = 0;
+    int mismatches = 0;
+    start = now();
+    for (int i = 0; i < n; i++)
+	table_sum += ms_check_parity(frames[i]);
+    double table_cpu = now() - start;
+    for (int i = 0; i < n; i++)
+	if(bit_check_parity(frames[i]) != ms_check_parity(frames[i]))
+		mismatches++;
+
+    printf("%d frames\n", n);
+    printf("bit loop    %8.1f ns per frame\n", bit_cpu * 1e9 / n);
+    printf("byte table  %8.1f ns per frame  %.1fx\n", table_cpu * 1e9 / n, bit_cpu / table_cpu);
+    printf("%d mismatches %s\n", mismatches, (bit_sum == table_sum) ? "" : "checksum differs");
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Benchmark of the Mode S preamble search
+ *
+ * Builds a synthetic magnitude stream of noise and Mode S frames, marks the
+ * pulses like ms_mag_pulse_detect and runs the preamble search over it with
+ * the first stage template filter off and on, and with the detector built for
+ * any rate and, when there is one, for the channel rate.
+ *
+ * usage: benchmark_ms_preamble [channel_rate [seconds]]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <air_ms_types.h>
+#include <airi_ms_preamble.h>
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float noise()
+{
+    // Rayleigh distributed magnitude
+    float u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrtf(-2.0 * logf(u)) * 0.05;
+}
+
+// Add a frame of random bits at pos, returns the samples used
+static int add_frame(std::vector<float> &mag, int pos, int channel_rate, float level)
+{
+    int chip = channel_rate / 2000000;
+    int preamble[4] = {0, 2, 7, 9};  // Preamble pulses in chips
+    int nbits = (rand() & 1) ? MS_LONG_FRAME_LENGTH : MS_SHORT_FRAME_LENGTH;
+    int end = pos + (16 + 2 * nbits) * chip;
+    if(end >= (int)mag.size())
+	return 0;
+    for (int p = 0; p < 4; p++)
+	for (int k = 0; k < chip; k++)
+		mag[pos + preamble[p] * chip + k] += level;
+    for (int b = 0; b < nbits; b++)
+    {
+	int c = 16 + 2 * b + (rand() & 1);
+	for (int k = 0; k < chip; k++)
+		mag[pos + c * chip + k] += level;
+    }
+    return end - pos;
+}
+
+// Same marking as ms_mag_pulse_detect
+static void detect(const std::vector<float> &mag, std::vector<ms_plinfo> &attrib, float alpha, float beta, int width)
+{
+    int t_count = 0;
+    for (int i = 0; i < (int)mag.size() - 1; i++)
+    {
+	if(mag[i] >= beta)
+	{
+		if(++t_count > width)
+		{
+			int pos = i - width;
+			float before = (pos > 0) ? mag[pos - 1] : 0.0;
+			attrib[pos].set_valid_pulse();
+			if((mag[pos] >= (before * alpha)) && (mag[pos + 1] < (mag[pos] * alpha)))
+				attrib[pos].set_leading_edge();
+		}
+	}
+	else
+		t_count = 0;
+    }
+}
+
+template <int RATE>
+static void run(const char *name, const std::vector<float> &mag, const std::vector<ms_plinfo> &attrib,
+                int channel_rate, bool prefilter, double seconds)
+{
+    ms_preamble_detector<RATE> det(channel_rate, prefilter);
+    const int block = 32768;
+    unsigned long preambles = 0;
+    float reference;
+    double start = now();
+    for (int base = 0; base + block <= (int)mag.size(); base += block - det.check_width())
+    {
+	int size = block - det.check_width();
+	det.scan(&attrib[base], size);
+	for (int i = det.find(&mag[base], &attrib[base], 0, size, reference); i < size;
+	     i = det.find(&mag[base], &attrib[base], i + 1, size, reference))
+		preambles++;
+    }
+    double cpu = now() - start;
+    printf("%-10s %10lu candidates %10lu exact checks %8lu preambles  %8.1f M candidates/s  %6.3f ms CPU per Msps\n",
+           name, det.candidates(), det.survivors(), preambles,
+           det.candidates() / cpu / 1e6, cpu * 1e3 / (seconds * channel_rate / 1e6));
+}
+
+int main(int argc, char **argv)
+{
+    int channel_rate = (argc > 1) ? atoi(argv[1]) : 10000000;
+    double seconds = (argc > 2) ? atof(argv[2]) : 1.0;
+    int n = (int)(seconds * channel_rate);
+    std::vector<float> mag(n);
+    std::vector<ms_plinfo> attrib(n);
+    srand(1);
+    for (int i = 0; i < n; i++)
+	mag[i] = noise();
+    // About 2000 frames per second of random levels
+    int frames = 0;
+    for (int pos = 0; pos < n; )
+    {
+	int used = add_frame(mag, pos, channel_rate, 0.1 + (rand() % 100) * 0.01);
+	if(used == 0)
+		break;
+	frames++;
+	pos += used + rand() % (channel_rate / 1000);
+    }
+    detect(mag, attrib, powf(10., 2.0/20.), 0.08, channel_rate / 4000000);
+    printf("%d Msps, %.1f s, %d frames\n", channel_rate / 1000000, seconds, frames);
+    run<MS_RATE_RUNTIME>("exact", mag, attrib, channel_rate, false, seconds);
+    run<MS_RATE_RUNTIME>("prefilter", mag, attrib, channel_rate, true, seconds);
+    switch(channel_rate)
+    {
+    case 8000000:
+	run<8000000>("fixed", mag, attrib, channel_rate, true, seconds);
+	break;
+    case 10000000:
+	run<10000000>("fixed", mag, attrib, channel_rate, true, seconds);
+	break;
+    case 16000000:
+	run<16000000>("fixed", mag, attrib, channel_rate, true, seconds);
+	break;
+    case 20000000:
+	run<20000000>("fixed", mag, attrib, channel_rate, true, seconds);
+	break;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Benchmark of the preamble time of arrival estimate
+ *
+ * Builds preambles that start a random fraction of a sample into the stream,
+ * each sample being the mean of the pulse over the sample time centred on it,
+ * adds noise
+ * and times ms_toa_estimator over them.  Prints the CPU time per frame and
+ * the error of the estimate for a few signal to noise ratios.
+ *
+ * usage: benchmark_ms_toa [channel_rate [frames]]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <air_ms_consts.h>
+#include <airi_ms_toa.h>
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float gaussian()
+{
+    float u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    float v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrtf(-2.0 * logf(u)) * cosf(2.0 * M_PI * v);
+}
+
+// Part of the sample time around k covered by the interval a to b
+static float overlap(int k, double a, double b)
+{
+    double lo = (a > k - 0.5) ? a : k - 0.5;
+    double hi = (b < k + 0.5) ? b : k + 0.5;
+    return (hi > lo) ? hi - lo : 0.0;
+}
+
+static void run(int channel_rate, int frames, float snr_db)
+{
+    const int stride = 128;   // Samples per preamble, enough for the pulses and the edge search
+    const int lead = 8;       // Samples before the preamble
+    double us = channel_rate / 1e6;
+    double pulses[MS_PREAMBLE_PULSE_COUNT] = { 0.0, 1.0, 3.5, 4.5 };  // Pulse starts in uS
+    float sigma = powf(10.0, -snr_db / 20.0);
+    std::vector<float> data(frames * stride);
+    std::vector<double> start(frames);
+    srand(1);
+    for (int f = 0; f < frames; f++)
+    {
+	float *p = &data[f * stride];
+	start[f] = lead + rand() / (RAND_MAX + 1.0);
+	for (int k = 0; k < stride; k++)
+	{
+		float v = 0.0;
+		for (int j = 0; j < MS_PREAMBLE_PULSE_COUNT; j++)
+			v += overlap(k, start[f] + pulses[j] * us, start[f] + (pulses[j] + 0.5) * us);
+		p[k] = fabsf(v + sigma * gaussian());
+	}
+    }
+    std::vector<float> offsets(frames);
+    std::vector<char> found(frames);
+    ms_toa_estimator toa(channel_rate);
+    double t0 = now();
+    for (int f = 0; f < frames; f++)
+	found[f] = toa.estimate(&data[f * stride], lead, 1.0, offsets[f]);
+    double cpu = now() - t0;
+    int n = 0;
+    double sum2 = 0.0;
+    for (int f = 0; f < frames; f++)
+    {
+	if(!found[f])
+		continue;
+	double e = lead + offsets[f] - start[f];
+	sum2 += e * e;
+	n++;
+    }
+    double rms = n ? sqrt(sum2 / n) : 0.0;
+    printf("%5.1f dB  %6.1f ns/frame  %6.2f%% estimated  rms error %.4f samples %6.2f ns\n",
+           snr_db, cpu * 1e9 / frames, 100.0 * n / frames, rms, rms * 1e9 / channel_rate);
+}
+
+int main(int argc, char **argv)
+{
+    int channel_rate = (argc > 1) ? atoi(argv[1]) : 10000000;
+    int frames = (argc > 2) ? atoi(argv[2]) : 200000;
+    printf("%d Msps, %d frames\n", channel_rate / 1000000, frames);
+    run(channel_rate, frames, 40.0);
+    run(channel_rate, frames, 25.0);
+    run(channel_rate, frames, 15.0);
+    return 0;
+}
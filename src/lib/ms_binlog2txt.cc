@@ -0,0 +1,76 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Convert a Mode S binary log to text
+ *
+ * Writes the records of a log from ms_fmt_binlog as the lines ms_fmt_log
+ * would have given for the same frames, one to a line.
+ *
+ * usage: ms_binlog2txt logfile [textfile]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <air_ms_types.h>
+#include <air_ms_binlog.h>
+#include <airi_ms_fmt_text.h>
+
+int main(int argc, char **argv)
+{
+    if((argc < 2) || (argc > 3))
+    {
+	fprintf(stderr, "usage: %s logfile [textfile]\n", argv[0]);
+	return 1;
+    }
+    ms_binlog_reader log;
+    if(!log.open(argv[1]))
+    {
+	fprintf(stderr, "%s\n", log.error().c_str());
+	return 1;
+    }
+    FILE *out = stdout;
+    if((argc > 2) && !(out = fopen(argv[2], "w")))
+    {
+	perror(argv[2]);
+	return 1;
+    }
+    static char buffer[1 << 20];
+    setvbuf(out, buffer, _IOFBF, sizeof(buffer));
+    ms_frame_raw frame;
+    char line[MS_FMT_TEXT_MAX + 1];
+    for (size_t i = 0; i < log.size(); i++)
+    {
+	log.frame(i, frame);
+	int n = ms_fmt_text(frame, line);
+	line[n++] = '\n';
+	fwrite(line, 1, n, out);
+    }
+    if(fclose(out) != 0)
+    {
+	perror((argc > 2) ? argv[2] : "stdout");
+	return 1;
+    }
+    return 0;
+}
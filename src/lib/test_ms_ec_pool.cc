@@ -0,0 +1,165 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Test of the latency limit of the error correction pool
+ *
+ * The one worker is held up until the test lets it go, so the frames are
+ * past the maximum latency however fast the machine is.  Taken without
+ * waiting, as the scheduler does while input is flowing, each frame must
+ * come out once it is past the limit, in order and as eq_ec_deferred.
+ * Returns non zero otherwise.
+ *
+ * usage: test_ms_ec_pool
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <boost/thread.hpp>
+#include <air_ms_types.h>
+#include <airi_ms_parity.h>
+#include <airi_ms_ec.h>
+#include <airi_ms_ec_pool.h>
+
+const int FRAMES = 8;
+const double MAX_LATENCY_MS = 20.0;
+const double GIVE_UP_MS = 10000.0;  // Only a pool that never takes them late
+
+// A worker that waits in correct() until it is released
+class held_workers : public ms_ec_workers
+{
+public:
+    held_workers() : ms_ec_workers(1, MS_EC_MAX_LCBS, FRAMES, MAX_LATENCY_MS), d_held(true) {}
+
+    void release()
+    {
+	boost::mutex::scoped_lock lock(d_gate);
+	d_held = false;
+	d_released.notify_all();
+    }
+
+protected:
+    void correct(int id, ms_frame_raw &frame)
+    {
+	{
+		boost::mutex::scoped_lock lock(d_gate);
+		while(d_held)
+			d_released.wait(lock);
+	}
+	ms_ec_workers::correct(id, frame);
+    }
+
+private:
+    bool d_held;
+    boost::mutex d_gate;
+    boost::condition_variable d_released;
+};
+
+// A frame with good parity and max_lcbs low confidence bits, a few flipped
+static void slow_frame(ms_frame_raw &frame, int max_lcbs)
+{
+    frame.reset_all();
+    frame.set_long_frame();
+    int j;
+    for(j = 0; j < MS_LONG_FRAME_LENGTH - 24; j++)
+	frame.set_bit_high_confidence(j, rand() & 1);
+    unsigned int parity = ms_check_parity(frame);
+    for(j = 0; j < 24; j++)
+	frame.set_bit_high_confidence(MS_LONG_FRAME_LENGTH - 24 + j, (parity >> (23 - j)) & 1);
+    while(frame.lcb_count() < max_lcbs)
+    {
+	j = rand() % MS_LONG_FRAME_LENGTH;
+	frame.set_bit_low_confidence(j, frame.bit(j));
+    }
+    for(int k = 0; k < 4; k++)
+    {
+	do
+		j = rand() % MS_LONG_FRAME_LENGTH;
+	while(!frame.bit_low_confidence(j));
+	frame.set_bit_flipped(j);
+    }
+    frame.set_ec_quality(ms_frame_raw::crc_bad);
+}
+
+static double age_ms(const boost::system_time &t)
+{
+    return (boost::get_system_time() - t).total_microseconds() / 1000.0;
+}
+
+int main()
+{
+    held_workers workers;
+    ms_frame_raw frame;
+    boost::system_time added = boost::get_system_time();
+    srand(1);
+    for(int i = 0; i < FRAMES; i++)
+    {
+	slow_frame(frame, MS_EC_MAX_LCBS);
+	frame.set_timestamp(i);
+	workers.push(frame);
+    }
+    int status = 0;
+    for(int out = 0; out < FRAMES; out++)
+    {
+	while(!workers.pop(frame, false))
+	{
+		if(age_ms(added) > GIVE_UP_MS)
+		{
+			fprintf(stderr, "frame %d not taken without waiting\n", out);
+			workers.release();
+			return 1;
+		}
+		boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+	}
+	// Added after the time was taken so at least as old as this
+	double age = age_ms(added);
+	if(frame.timestamp() != (uint64_t)out)
+	{
+		fprintf(stderr, "frame %d out of order\n", out);
+		status = 1;
+	}
+	else if(age < MAX_LATENCY_MS)
+	{
+		fprintf(stderr, "frame %d taken uncorrected after %.1f ms\n", out, age);
+		status = 1;
+	}
+	else if(frame.ec_quality() != ms_frame_raw::eq_ec_deferred)
+	{
+		fprintf(stderr, "frame %d taken late as %#x\n", out, frame.ec_quality());
+		status = 1;
+	}
+    }
+    if(workers.late_frames() != (unsigned long)FRAMES)
+    {
+	fprintf(stderr, "%lu of %d frames counted late\n", workers.late_frames(), FRAMES);
+	status = 1;
+    }
+    // Nothing may be left in the worker when it goes
+    workers.release();
+    while(workers.queue_depth() > 0)
+	boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    printf("%d frames taken late for a limit of %.0f ms\n", FRAMES, MAX_LATENCY_MS);
+    return status;
+}
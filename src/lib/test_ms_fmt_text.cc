@@ -0,0 +1,257 @@
+/*
+ * Copyright 2007 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Test of the text log formatter
+ *
+ * Compares ms_fmt_text byte for byte with the iostream formatting it
+ * replaced, on random frames with levels near the rounding boundaries of the
+ * reference field, and on the frames of any binary logs given.  Prints the
+ * time a line of each and returns non zero on the first difference.
+ *
+ * usage: test_ms_fmt_text [frames] [binary logs]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <air_ms_types.h>
+#include <air_ms_binlog.h>
+#include <airi_ms_fmt_text.h>
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t random64()
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 4; i++)
+	v = (v << 16) ^ (rand() & 0xffff);
+    return v;
+}
+
+// The iostream formatting
+static void stream_fmt_text(const ms_frame_raw &frame, std::ostringstream &payload)
+{
+    int i;
+    int typecode = 0;
+    int data = 0;
+    int pi = 0;
+    for (i = 0; i < 5; i++)
+    {
+       typecode = (typecode << 1) + frame.bit(i);
+       data = (data << 1) + frame.bit(i);
+    }
+    for (i = 5; i < 32; i++)
+    {
+        data = (data << 1) + frame.bit(i);
+    }
+
+    payload.str("");
+    payload.width(8);
+    payload.fill('0');
+    payload << std::hex <<  data << FIELD_DELIM;
+
+    if(frame.length() >= MS_LONG_FRAME_LENGTH)
+    {
+        data = 0;
+        payload.width(7);
+        for (i = 32; i < 60; i++)
+        {
+             data = (data << 1) + frame.bit(i);
+        }
+        payload << data;
+        data = 0;
+        payload.width(7);
+        for (i = 60; i < 88; i++)
+        {
+             data = (data << 1) + frame.bit(i);
+        }
+        payload << data << FIELD_DELIM;
+        payload.width(6);
+        for (i = 88; i < MS_LONG_FRAME_LENGTH; i++)
+        {
+             pi = (pi << 1) + frame.bit(i);
+        }
+        payload << pi << FIELD_DELIM;
+    }
+    else
+    {
+        for (i = 32; i < MS_SHORT_FRAME_LENGTH; i++)
+        {
+             pi = (pi << 1) + frame.bit(i);
+        }
+        payload << FIELD_DELIM << "             " << FIELD_DELIM;
+        payload.width(6);
+        payload << pi << FIELD_DELIM;
+    }
+    
+    payload.width(7);
+    payload.precision(5);
+    payload.fill(' ');
+    payload << std::dec << frame.reference() << FIELD_DELIM;
+    
+    payload.width(8);
+    payload.fill('0');
+    payload << std::hex << frame.timestamp() << FIELD_DELIM << frame.rx_time() << FIELD_DELIM;
+    
+    payload.width(3);
+    payload.fill(' ');
+    payload << std::dec << frame.lcb_count() << FIELD_DELIM;
+    
+    payload.width(8);
+    payload.fill('0');
+    payload << std::hex << frame.ec_quality() << FIELD_DELIM;
+    
+    payload.width(2);
+    payload << std::dec << typecode << FIELD_DELIM;
+    
+    payload.width(6);
+    payload << std::hex << frame.address();
+}
+
+// Levels that end in a 5 past the fifth digit or round up a digit
+static float edge_level()
+{
+    static const float edges[] = { 99999.5f, 99999.4f, 99995.0f, 9.99995f, 9.99994f, 0.999995f,
+                                   1e-4f, 9.99995e-5f, 1e5f, 12345.5f, 12344.5f, 1.00005f, 0.5f,
+                                   0.0f, -0.0f, 1e-45f, 1e38f, 3.4028235e38f, -1.5f, 123.456f };
+    int n = sizeof(edges) / sizeof(edges[0]);
+    float v = edges[rand() % n];
+    int step = rand() % 5 - 2;   // Neighbouring floats
+    for (; step > 0; step--)
+	v = nextafterf(v, HUGE_VALF);
+    for (; step < 0; step++)
+	v = nextafterf(v, -HUGE_VALF);
+    return v;
+}
+
+static float random_level()
+{
+    switch(rand() % 8)
+    {
+    case 0:
+	{
+		unsigned int u = random64();   // Any float, nan and inf too
+		float v;
+		memcpy(&v, &u, sizeof(v));
+		return v;
+	}
+    case 1:
+	return edge_level();
+    case 2:
+	return rand() % 200000 / 2.0f;   // Halves up to 1e5
+    case 3:
+	return (rand() % 2000000 - 1000000) * powf(10.0f, rand() % 12 - 9);
+    default:
+	return powf(10.0f, (rand() % 100000) / 10000.0f - 5.0f);   // 1e-5 to 1e5
+    }
+}
+
+static void random_frame(ms_frame_raw &frame)
+{
+    frame.reset_all();
+    int length = rand() % 3;
+    if(length == 1)
+	frame.set_short_frame();
+    else if(length == 2)
+	frame.set_long_frame();
+    int lcbs = rand() % 4;   // Mostly no low confidence bits
+    for (int i = 0; i < MS_LONG_FRAME_LENGTH; i++)
+    {
+	int bit = rand() & 1;
+	if(lcbs && (rand() % (lcbs * 8) == 0))
+		frame.set_bit_low_confidence(i, bit);
+	else
+		frame.set_bit_high_confidence(i, bit);
+    }
+    frame.set_reference(random_level());
+    frame.set_timestamp(random64() >> (rand() % 64));
+    frame.set_rx_time_ns(random64() >> (rand() % 64));
+    frame.set_ec_quality(rand() & 0xffff);
+    frame.set_address(random64() >> (rand() % 33));
+}
+
+int main(int argc, char **argv)
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+    std::vector<ms_frame_raw> frames(n);
+    srand(1);
+    for (int i = 0; i < n; i++)
+	random_frame(frames[i]);
+    for (int k = 2; k < argc; k++)
+    {
+	ms_binlog_reader log;
+	if(!log.open(argv[k]))
+	{
+		fprintf(stderr, "%s\n", log.error().c_str());
+		return 1;
+	}
+	size_t first = frames.size();
+	frames.resize(first + log.size());
+	for (size_t i = 0; i < log.size(); i++)
+		log.frame(i, frames[first + i]);
+    }
+
+    std::ostringstream payload;
+    char line[MS_FMT_TEXT_MAX];
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+	stream_fmt_text(frames[i], payload);
+	int len = ms_fmt_text(frames[i], line);
+	const std::string &s = payload.str();
+	if((s.size() != (size_t)len) || (memcmp(s.data(), line, len) != 0))
+	{
+		fprintf(stderr, "frame %lu differs, reference %.9g\n", (unsigned long)i, frames[i].reference());
+		fprintf(stderr, "stream: \"%s\"\ntable:  \"%.*s\"\n", s.c_str(), len, line);
+		return 1;
+	}
+    }
+
+    unsigned int sum = 0;   // So the formatting is not optimised out
+    double t0 = now();
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+	stream_fmt_text(frames[i], payload);
+	sum += payload.str()[0];
+    }
+    double t1 = now();
+    for (size_t i = 0; i < frames.size(); i++)
+	sum += ms_fmt_text(frames[i], line) + line[0];
+    double t2 = now();
+    printf("%lu frames the same\n", (unsigned long)frames.size());
+    printf("stream: %.1f ns a line\n", (t1 - t0) * 1e9 / frames.size());
+    printf("table:  %.1f ns a line (%u)\n", (t2 - t1) * 1e9 / frames.size(), sum);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#!/usr/bin/env python
+#
+# Copyright 2007 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+from gnuradio import gr, gru, blks2, air
+from gnuradio.eng_option import eng_option
+from optparse import OptionParser
+import time, os, tempfile
+
+"""
+Compares the Mode S demodulator chain (ms_preamble, ms_framer and
+ms_ppm_decode) with the fused ms_demod block on a recorded channel.
+
+The input file is complex float samples at the channel rate.  The decode
+rate of each and whether they give the same frames is printed.  With
+--lowrate the recording is also resampled to 2 or 2.4 Msps and decoded by
+ms_demod_lowrate.  The frames with a zero syndrome are counted for each so
+the low rate decode can be compared with the full rate one.
+"""
+
+class demod_graph(gr.top_block):
+    def __init__(self, options, filename, fused, queue, lowrate=0):
+        gr.top_block.__init__(self)
+
+        rate = int(options.rate)
+        src = gr.file_source(gr.sizeof_gr_complex, filename)
+        if lowrate:
+            demod = air.ms_demod_lowrate(lowrate, options.thresh)
+            self.connect(src, gr.complex_to_mag(), demod, air.ms_parity(), air.ms_fmt_log(1, queue))
+            return
+        leading_edge = 48.0/(rate/1000000.0)
+        valid_pulse_position = 2
+        if rate == 10000000:
+            valid_pulse_position = 3
+        detect = air.ms_mag_pulse_detect(leading_edge, options.thresh, valid_pulse_position)
+        self.connect(src, detect)
+        if fused:
+            demod = air.ms_demod(rate)
+            self.connect((detect, 0), (demod, 0))
+            self.connect((detect, 1), (demod, 1))
+        else:
+            sync = air.ms_preamble(rate)
+            frame = air.ms_framer(rate)
+            demod = air.ms_ppm_decode(rate)
+            self.connect((detect, 0), (sync, 0))
+            self.connect((detect, 1), (sync, 1))
+            self.connect((detect, 0), (frame, 0))
+            self.connect(sync, (frame, 1))
+            self.connect((detect, 0), (demod, 0))
+            self.connect(frame, (demod, 1))
+        self.connect(demod, air.ms_parity(), air.ms_fmt_log(1, queue))
+
+class resample_graph(gr.top_block):
+    def __init__(self, rate, lowrate, filename, outname):
+        gr.top_block.__init__(self)
+        interp = gru.lcm(rate, lowrate)/rate
+        decim = gru.lcm(rate, lowrate)/lowrate
+        self.connect(gr.file_source(gr.sizeof_gr_complex, filename),
+                     blks2.rational_resampler_ccf(interp, decim),
+                     gr.file_sink(gr.sizeof_gr_complex, outname))
+
+def run(options, filename, fused, lowrate=0):
+    queue = gr.msg_queue()
+    tb = demod_graph(options, filename, fused, queue, lowrate)
+    start = time.time()
+    tb.run()
+    elapsed = time.time() - start
+    frames = []
+    while queue.count():
+        f = queue.delete_head().to_string().split()
+        del f[-5]  # Decode time
+        frames.append(f)
+    return frames, elapsed
+
+def main():
+    usage="%prog: [options] input_filename"
+    parser = OptionParser(option_class=eng_option, usage=usage)
+    parser.add_option("-r", "--rate", type="eng_float", default=10e6,
+                      help="set channel rate to RATE [default=%default]")
+    parser.add_option("-T", "--thresh", type="int", default=10,
+                      help="set valid pulse threshold to THRESH [default=%default]")
+    parser.add_option("-l", "--lowrate", type="eng_float", default=0,
+                      help="also decode the recording resampled to LOWRATE, 2M or 2.4M [default=off]")
+    (options, args) = parser.parse_args()
+
+    if len(args) != 1:
+        parser.print_help()
+        raise SystemExit, 1
+
+    filename = args[0]
+    samples = os.path.getsize(filename) / gr.sizeof_gr_complex
+
+    def good(frames):
+        # Zero syndrome, the parity is good and no address is overlaid
+        return len([f for f in frames if f[-3] == "00000001" and f[-1] == "000000"])
+
+    for (name, fused) in (("chain", False), ("ms_demod", True)):
+        frames, elapsed = run(options, filename, fused)
+        if not fused:
+            expected = frames
+        print "%-16s %6d frames %6d good %8.2f Msps" % (name, len(frames), good(frames), samples / elapsed / 1e6)
+    match = (frames == expected)
+
+    if options.lowrate:
+        lowrate = int(options.lowrate)
+        (fd, lowname) = tempfile.mkstemp()
+        os.close(fd)
+        try:
+            resample_graph(int(options.rate), lowrate, filename, lowname).run()
+            lowsamples = os.path.getsize(lowname) / gr.sizeof_gr_complex
+            frames, elapsed = run(options, lowname, True, lowrate)
+            print "%-16s %6d frames %6d good %8.2f Msps" % ("ms_demod_lowrate", len(frames), good(frames), lowsamples / elapsed / 1e6)
+        finally:
+            os.remove(lowname)
+
+    if match:
+        print "Frames match"
+    else:
+        print "Frames differ"
+        raise SystemExit, 1
+
+if __name__ == "__main__":
+    main()
@@ -18,7 +18,7 @@
 # the Free Software Foundation, Inc., 51 Franklin Street,
 # Boston, MA 02110-1301, USA.
 #
-from gnuradio import gr, gru, air
+from gnuradio import gr, gru, blks2, air
 
 risetime_threshold_db = 48.0    # The minimum change for pulse leading edge in dB per bit time (Assume value for 8 MHz BW)
 data_rate = 1000000.0           # Data rate in bits per second
@@ -29,37 +29,65 @@ class ppm_demod(gr.hier_block2):
     Mode S protocol demodulation block.
 
     This block demodulates a complex down-converted baseband
-    channel into Aviation Mode S protocol frames.
+    channel into Aviation Mode S protocol frames.  With iq_u8 the
+    channel is interleaved unsigned 8 bit IQ pairs, two bytes a sample,
+    at a rate that needs no resampling, and threshold is in sample units.
+    With fixed the magnitude is demodulated as unsigned short at 8
+    Msps and more, 64 units to the threshold for complex samples and 256 to a unit
+    of the 8 bit samples.
 
     Flow graph (so far):
 
-    RESAMP   - Resample Input Stream (if needed)
-    MAG      - Use Magitude function to get AM Pulses
-    DETECT   - Detects Valid Pulses and Leading Edges
-    SYNC     - Detects the Mode S Preamble
-    FRAME    - Frames the data
-    BIT      - Decodes the Pulse Position Modulation (PPM) to Mode S Data Frames
-    PARITY   - Parity Checking (CRC)
-    EC       - Brute Force Error Correction
+    RESAMP   - Resample Input Stream (if needed), to 10 or 8 Msps from 8 Msps or
+               more and to 2.4 Msps from less.  16 and 20 Msps are demodulated
+               as they are
+    DETECT   - Magnitude of the AM Pulses, Detects Valid Pulses and Leading Edges,
+               at 2 and 2.4 Msps just the magnitude.  With iq_u8 the magnitude is
+               looked up in a table
+    DEMOD    - Detects the Mode S Preamble, Frames the data and Decodes the
+               Pulse Position Modulation (PPM) to Mode S Data Frames in one pass,
+               with toa the arrival time of frames with good parity is refined to
+               a fraction of a sample.  At 2 and 2.4 Msps ms_demod_lowrate finds
+               the frames from the chip levels
+    PARITY   - Parity Checking (CRC), with address_cache the addresses of good
+               DF11/17/18 frames are cached to check and correct the frames
+               with the address overlaid on the parity
+    EC       - Error Correction of up to ec_max_lcbs (at most 24) Low Confidence Bits,
+               on ec_threads worker threads if not zero, or inline spending up
+               to ec_budget_us per call
     """
-    def __init__(self, channel_rate, threshold):
+    def __init__(self, channel_rate, threshold, ec_max_lcbs=12, ec_threads=0, ec_budget_us=0.0, address_cache=False, toa=False, iq_u8=False, fixed=False):
+        if iq_u8:
+            in_size = 2 * gr.sizeof_char
+        else:
+            in_size = gr.sizeof_gr_complex
         gr.hier_block2.__init__(self, "ppm_demod",
-                              gr.io_signature(1, 1, gr.sizeof_gr_complex),
-                              gr.io_signature(1, 1, 512))
+                              gr.io_signature(1, 1, in_size),
+                              gr.io_signature(1, 1, air.sizeof_ms_frame_raw))
 
-        chan_rate = 8000000 # Minimum sample rate
+        if channel_rate < 2000000:
+            raise ValueError, "Invalid channel rate %d. Must be 2000000 sps or higher" % (channel_rate)
 
-        if channel_rate < chan_rate:
-            raise ValueError, "Invalid channel rate %d. Must be 8000000 sps or higher" % (channel_rate)
-        
-        if channel_rate >= 10000000:
+        if channel_rate in (16000000, 20000000):
+            chan_rate = channel_rate  # The demodulator has builds for these rates
+        elif channel_rate >= 10000000:
             chan_rate = 10000000    # Higher Performance Receiver
+        elif channel_rate >= 8000000:
+            chan_rate = 8000000
+        elif channel_rate == 2000000:
+            chan_rate = 2000000     # Low rate receivers demodulate without resampling
+        else:
+            chan_rate = 2400000
+        lowrate = chan_rate < 8000000
+
+        if iq_u8 and channel_rate != chan_rate:
+            raise ValueError, "Invalid channel rate %d for 8 bit IQ. Must be 2000000, 2400000, 8000000, 10000000, 16000000 or 20000000 sps" % (channel_rate)
 
         # if rate is not supported then resample
         if channel_rate != chan_rate:
             interp = gru.lcm(channel_rate, chan_rate)/channel_rate
             decim  = gru.lcm(channel_rate, chan_rate)/chan_rate
-            self.RESAMP = rational_resampler_ccf(self, interp, decim)
+            self.RESAMP = blks2.rational_resampler_ccf(interp, decim)
 
         # Calculate the leading edge threshold per sample time
         leading_edge = risetime_threshold_db/(chan_rate/data_rate)
@@ -68,27 +96,48 @@ class ppm_demod(gr.hier_block2):
         valid_pulse_position = 2
         if chan_rate == 10000000:
             valid_pulse_position = 3
+        elif chan_rate > 10000000:
+            valid_pulse_position = int(chan_rate/chip_rate) - 2  # Two short of a chip
 
-        # Demodulate AM with classic sqrt (I*I + Q*Q)
-        self.MAG = gr.complex_to_mag()
-        self.DETECT = air.ms_pulse_detect(leading_edge, threshold, valid_pulse_position) # Attack, Threshold, Pulsewidth
-        self.SYNC = air.ms_preamble(chan_rate)
-        self.FRAME = air.ms_framer(chan_rate)
-        self.BIT   = air.ms_ppm_decode(chan_rate)
-        self.PARITY = air.ms_parity()
-        self.EC    =  air.ms_ec_brute()
+        if fixed and not lowrate:
+            # Half the sample stream and integer level tests
+            if iq_u8:
+                scale = 256.0
+                self.DETECT = air.ms_u8_pulse_detect_s(leading_edge, threshold, valid_pulse_position)
+            else:
+                scale = 64.0/threshold
+                self.DETECT = air.ms_mag_pulse_detect_s(leading_edge, threshold, valid_pulse_position, scale)
+            self.DEMOD = air.ms_demod_s(chan_rate, scale, toa)
+        elif iq_u8:
+            # Table lookup of the magnitude, only the magnitude output is used at low rates
+            self.DETECT = air.ms_u8_pulse_detect(leading_edge, threshold, valid_pulse_position)
+            if lowrate:
+                self.DEMOD = air.ms_demod_lowrate(chan_rate, threshold)
+            else:
+                self.DEMOD = air.ms_demod(chan_rate, toa)
+        elif lowrate:
+            # A chip is one or two samples, too few for pulse detection
+            self.DETECT = gr.complex_to_mag()
+            self.DEMOD = air.ms_demod_lowrate(chan_rate, threshold)
+        else:
+            # Demodulate AM with classic sqrt (I*I + Q*Q) and detect the pulses in the same pass
+            self.DETECT = air.ms_mag_pulse_detect(leading_edge, threshold, valid_pulse_position) # Attack, Threshold, Pulsewidth
+            self.DEMOD = air.ms_demod(chan_rate, toa)
+        self.PARITY = air.ms_parity(address_cache)
+        if ec_threads > 0:
+            self.EC = air.ms_ec_pool(ec_threads, ec_max_lcbs, 100.0, address_cache)
+        else:
+            self.EC = air.ms_ec_brute(ec_max_lcbs, ec_budget_us, address_cache)
 
         if channel_rate != chan_rate:
             # Resample the stream first
-            self.connect(self, self.RESAMP, self.MAG, self.DETECT)
+            self.connect(self, self.RESAMP, self.DETECT)
         else: 
-            self.connect(self, self.MAG, self.DETECT)
-
-        self.connect((self.DETECT, 0), (self.SYNC, 0))
-        self.connect((self.DETECT, 1), (self.SYNC, 1))
-        self.connect((self.SYNC, 0), (self.FRAME, 0))
-        self.connect((self.SYNC, 1), (self.FRAME, 1))
-        self.connect((self.FRAME, 0), (self.BIT, 0))
-        self.connect((self.FRAME, 1), (self.BIT, 1))
-        self.connect(self.BIT, self.PARITY, self.EC, self)
+            self.connect(self, self.DETECT)
 
+        if lowrate:
+            self.connect((self.DETECT, 0), self.DEMOD)
+        else:
+            self.connect((self.DETECT, 0), (self.DEMOD, 0))
+            self.connect((self.DETECT, 1), (self.DEMOD, 1))
+        self.connect(self.DEMOD, self.PARITY, self.EC, self)
@@ -21,15 +21,233 @@
 #
 
 from gnuradio import gr, gr_unittest
-import air_swig
+import air
+import math
+import random
+import struct
+
+def f32(x):
+    # Rounded to single precision
+    return struct.unpack('f', struct.pack('f', x))[0]
+
+def mag_f(c):
+    # sqrtf(re * re + im * im) as the detectors compute it
+    re = f32(c.real)
+    im = f32(c.imag)
+    return f32(math.sqrt(f32(f32(re * re) + f32(im * im))))
+
+def pulse_amplitude(i):
+    # Noise with a burst of strong samples every 35
+    if (i / 5) % 7 == 0:
+        return 30
+    return 3
+
+def make_frames(seed, n):
+    """n random DF11 and DF17 frames as (level, bits)"""
+    random.seed(seed)
+    frames = []
+    for f in range(n):
+        level = random.uniform(20.0, 60.0)
+        length = random.choice((56, 112))
+        df = (11, 17)[length == 112]  # The framer takes the length from the downlink format
+        bits = [(df >> (4 - b)) & 1 for b in range(5)]
+        bits += [random.randint(0, 1) for b in range(5, length)]
+        frames.append((level, bits))
+    return frames
+
+def frame_hex(bits):
+    return ''.join(['%02x' % int(''.join(map(str, bits[i:i+8])), 2) for i in range(0, len(bits), 8)])
+
+def frame_chips(bits):
+    # Preamble then a pulse in the first or second chip of each bit
+    chips = [1,0,1,0,0,0,0,1,0,1,0,0,0,0,0,0]
+    for bit in bits:
+        chips += [bit, 1 - bit]
+    return chips
+
+def demod_samples(frames, chip, cut_short=False, quantum=None):
+    """
+    Samples of the frames, chip samples to a chip, with noise and gaps between
+    them.  With cut_short every fifth frame is cut short by the next one.  With
+    quantum the samples are real whole multiples of it.
+    """
+    def sample(level):
+        if quantum:
+            return complex(round((level + random.uniform(-1.0, 1.0)) / quantum) * quantum, 0.0)
+        return complex(level + random.uniform(-1.0, 1.0), random.uniform(-1.0, 1.0))
+    src_data = []
+    for f in range(len(frames)):
+        level, bits = frames[f]
+        for c in frame_chips(bits):
+            src_data += [sample(c * level) for k in range(chip)]
+        if cut_short and f % 5 == 4:
+            src_data = src_data[:-random.randint(100, 400)]
+        else:
+            src_data += [sample(0.0) for k in range(random.randint(200, 2000))]
+    return src_data + [0j] * 20000
+
+def decode_lines(q):
+    """Fields of the ms_fmt_log lines in a message queue"""
+    lines = []
+    while q.count():
+        lines.append(q.delete_head().to_string().split())
+    return lines
+
+def without(fields, *columns):
+    # Drop the columns counted from the end, short frames have no extended field
+    return [fields[i] for i in range(len(fields)) if i - len(fields) not in columns]
+
+def line_hex(fields):
+    if len(fields) == 10:
+        return fields[0] + fields[1] + fields[2]  # Short, extended and parity
+    return fields[0] + fields[1]
+
+# Columns counted from the end of a line
+REFERENCE = -7
+DECODE_TIME = -5
+
+def assert_streams_equal(test, expected, result):
+    """
+    ms_cvt_float streams of two detectors.  The magnitudes to within rounding,
+    the references and attributes exactly.
+    """
+    for i in range(3):
+        n = min(len(expected[i]), len(result[i]))
+        test.assertTrue(n > 0)
+        if i == 0:
+            test.assertFloatTuplesAlmostEqual(expected[i][:n], result[i][:n], 4)
+        else:
+            test.assertEqual(expected[i][:n], result[i][:n])
 
 class qa_air(gr_unittest.TestCase):
 
     def setUp (self):
-        self.fg = gr.flow_graph ()
+        self.tb = gr.top_block ()
 
     def tearDown (self):
-        self.fg = None
+        self.tb = None
+
+    def detect_streams (self, *chain):
+        # Run the chain ending in a pulse detector into ms_cvt_float
+        cvt = air.ms_cvt_float()
+        dst = [gr.vector_sink_f() for i in range(3)]
+        self.tb.connect(*chain)
+        self.tb.connect((chain[-1], 0), (cvt, 0))
+        self.tb.connect((chain[-1], 1), (cvt, 1))
+        for i in range(3):
+            self.tb.connect((cvt, i), dst[i])
+        return dst
+
+    def test_001_mag_pulse_detect (self):
+        # The fused block must match ms_pulse_detect on the single precision magnitude
+        random.seed(1)
+        src_data = []
+        for i in range(20000):
+            a = pulse_amplitude(i)
+            src_data.append(complex(random.uniform(-a, a), random.uniform(-a, a)))
+        expected = self.detect_streams(gr.vector_source_f([mag_f(c) for c in src_data]),
+                                       air.ms_pulse_detect(6.0, 8.0, 3))
+        result = self.detect_streams(gr.vector_source_c(src_data), air.ms_mag_pulse_detect(6.0, 8.0, 3))
+        self.tb.run()
+        assert_streams_equal(self, [d.data() for d in expected], [d.data() for d in result])
+
+    def test_002_demod (self):
+        # The fused demodulator must give the same frames as ms_preamble, ms_framer and ms_ppm_decode
+        src = gr.vector_source_c(demod_samples(make_frames(2, 40), 5, cut_short=True))  # 10 Msps
+        detect = air.ms_mag_pulse_detect(4.8, 10.0, 3)
+        sync = air.ms_preamble(10000000)
+        frame = air.ms_framer(10000000)
+        bit = air.ms_ppm_decode(10000000)
+        demod = air.ms_demod(10000000)
+        chain_q = gr.msg_queue()
+        fused_q = gr.msg_queue()
+        self.tb.connect(src, detect)
+        self.tb.connect((detect, 0), (sync, 0))
+        self.tb.connect((detect, 1), (sync, 1))
+        self.tb.connect((detect, 0), (frame, 0))
+        self.tb.connect(sync, (frame, 1))
+        self.tb.connect((detect, 0), (bit, 0))
+        self.tb.connect(frame, (bit, 1))
+        self.tb.connect(bit, air.ms_fmt_log(1, chain_q))
+        self.tb.connect((detect, 0), (demod, 0))
+        self.tb.connect((detect, 1), (demod, 1))
+        self.tb.connect(demod, air.ms_fmt_log(1, fused_q))
+        self.tb.run()
+        expected = [without(f, DECODE_TIME) for f in decode_lines(chain_q)]
+        result = [without(f, DECODE_TIME) for f in decode_lines(fused_q)]
+        self.assertTrue(len(expected) > 20)
+        self.assertEqual(expected, result)
+
+    def test_003_demod_lowrate (self):
+        # Frames at 2.4 Msps starting anywhere in a sample are sliced without bit errors
+        frames = make_frames(3, 40)
+        ticks = []  # A chip is six ticks of a fifth of a sample
+        for level, bits in frames:
+            ticks += [0.0] * random.randint(500, 5000)
+            for c in frame_chips(bits):
+                ticks += [c * level] * 6
+        ticks += [0.0] * 10000
+        src_data = [complex(sum(ticks[i:i+5]) / 5.0 + random.uniform(-1.0, 1.0), 0.0)
+                    for i in range(0, len(ticks) - 4, 5)]
+        src = gr.vector_source_c(src_data)
+        mag = gr.complex_to_mag()
+        demod = air.ms_demod_lowrate(2400000, 10.0)
+        q = gr.msg_queue()
+        self.tb.connect(src, mag, demod, air.ms_fmt_log(1, q))
+        self.tb.run()
+        self.assertEqual([frame_hex(bits) for level, bits in frames], [line_hex(f) for f in decode_lines(q)])
+
+    def test_004_u8_pulse_detect (self):
+        # Unsigned 8 bit IQ must detect the same pulses as the complex samples they are
+        random.seed(4)
+        src_data = []
+        src_complex = []
+        for i in range(20000):
+            a = pulse_amplitude(i)
+            iq = (random.randint(127 - a, 128 + a), random.randint(127 - a, 128 + a))
+            src_data += iq
+            src_complex.append(complex(iq[0] - 127.5, iq[1] - 127.5))
+        expected = self.detect_streams(gr.vector_source_c(src_complex), air.ms_mag_pulse_detect(6.0, 8.0, 3))
+        result = self.detect_streams(gr.vector_source_b(src_data), gr.stream_to_vector(gr.sizeof_char, 2),
+                                     air.ms_u8_pulse_detect(6.0, 8.0, 3))
+        self.tb.run()
+        assert_streams_equal(self, [d.data() for d in expected], [d.data() for d in result])
+
+    def test_005_demod_s (self):
+        # Fixed point samples are demodulated without bit errors
+        frames = make_frames(5, 40)
+        src = gr.vector_source_c(demod_samples(frames, 5))  # 10 Msps
+        detect = air.ms_mag_pulse_detect_s(4.8, 10.0, 3, 6.4)
+        demod = air.ms_demod_s(10000000, 6.4)
+        q = gr.msg_queue()
+        self.tb.connect(src, detect)
+        self.tb.connect((detect, 0), (demod, 0))
+        self.tb.connect((detect, 1), (demod, 1))
+        self.tb.connect(demod, air.ms_fmt_log(1, q))
+        self.tb.run()
+        self.assertEqual([frame_hex(bits) for level, bits in frames], [line_hex(f) for f in decode_lines(q)])
+
+    def test_006_demod_s_float (self):
+        # Fixed point demodulation must give the frames of the float demodulator but
+        # for the reference level.  The samples are whole units of scale 6.4, 0.15625,
+        # so the fixed point samples are the float ones exactly
+        src = gr.vector_source_c(demod_samples(make_frames(6, 40), 5, cut_short=True, quantum=0.15625))
+        detect = air.ms_mag_pulse_detect(4.8, 10.0, 3)
+        demod = air.ms_demod(10000000)
+        detect_s = air.ms_mag_pulse_detect_s(4.8, 10.0, 3, 6.4)
+        demod_s = air.ms_demod_s(10000000, 6.4)
+        float_q = gr.msg_queue()
+        fixed_q = gr.msg_queue()
+        for d, m, q in ((detect, demod, float_q), (detect_s, demod_s, fixed_q)):
+            self.tb.connect(src, d)
+            self.tb.connect((d, 0), (m, 0))
+            self.tb.connect((d, 1), (m, 1))
+            self.tb.connect(m, air.ms_fmt_log(1, q))
+        self.tb.run()
+        expected = [without(f, REFERENCE, DECODE_TIME) for f in decode_lines(float_q)]
+        result = [without(f, REFERENCE, DECODE_TIME) for f in decode_lines(fixed_q)]
+        self.assertTrue(len(expected) > 20)
+        self.assertEqual(expected, result)
 
 if __name__ == '__main__':
     gr_unittest.main ()
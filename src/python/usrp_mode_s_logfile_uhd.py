@@ -19,7 +19,7 @@ blocks:
 
 USRP  - Daughter board source generating complex baseband signal.
 MODE_S - Mode S transponder protocol decoder
-FORMAT - Format Mode S Frames for logging
+FORMAT - Format Mode S Frames and write the log file, as text or binary records
 
 The following are optional command line parameters:
 
@@ -29,6 +29,9 @@ The following are optional command line parameters:
 -d DECIM     USRP decimation rate
 -t THRESH    Receiver valid pulse threshold
 -a           Output all frames. Defaults only output frames
+-b           Write the binary log of ms_fmt_binlog, ms_binlog2txt converts it
+-r MB        Rotate the log when it would go over MB megabytes
+-s SECONDS   Rotate the log when it is SECONDS old
 
 Once the program is running, ctrl-break (Ctrl-C) stops operation.
 """
@@ -44,7 +47,7 @@ def pick_subdevice(u):
                                 usrp_dbid.BASIC_RX))
 
 class app_flow_graph(gr.top_block):
-    def __init__(self, options, args, queue):
+    def __init__(self, options, args):
         gr.top_block.__init__(self)
 
         self.options = options
@@ -84,7 +87,7 @@ class app_flow_graph(gr.top_block):
         if options.output_all:
             pass_all = 1
 
-        self.format = air.ms_fmt_log(pass_all, queue)
+        self.format = air.ms_log_sink(pass_all, args[0], options.binary, 1, options.rotate_mb, options.rotate_seconds)
         self.connect(self.u, self.mode_s, self.format)
 
 def main():
@@ -102,6 +105,12 @@ def main():
                       help="set valid pulse threshold to THRESH [default=%default]")
     parser.add_option("-a","--output-all", action="store_true", default=False,
                       help="output all frames, not just valid")
+    parser.add_option("-b","--binary", action="store_true", default=False,
+                      help="write a binary log")
+    parser.add_option("-r", "--rotate-mb", type="eng_float", default=0.0,
+                      help="rotate the log when it would go over MB megabytes", metavar="MB")
+    parser.add_option("-s", "--rotate-seconds", type="eng_float", default=0.0,
+                      help="rotate the log when it is SECONDS old", metavar="SECONDS")
     (options, args) = parser.parse_args()
 
     if len(args) != 1:
@@ -112,19 +121,14 @@ def main():
 
     options.freq *= 1e6
 
-    queue = gr.msg_queue()
-
-    fg = app_flow_graph(options, args, queue)
+    open(filename, "w").close()  # Start a new log, the format block appends
+    fg = app_flow_graph(options, args)
+    fg.start()
     try:
-        fileHandle = open(filename, "w")
-        fg.start()
-        while 1:
-            msg = queue.delete_head() # Blocking read
-            fileHandle.write( msg.to_string()+"\n")
-            fileHandle.flush()
+        fg.wait()
     except KeyboardInterrupt:
         fg.stop()
-        fileHandle.close()
+        fg.wait()
 
 if __name__ == "__main__":
     main()
@@ -143,10 +143,10 @@ class app_flow_graph(stdgui2.std_top_block):
         self.connect(self.u, self.mag, self.detect)
 	self.connect((self.detect, 0), (self.sync, 0))
 	self.connect((self.detect, 1), (self.sync, 1))
-	self.connect((self.sync, 0), (self.frame, 0))
-	self.connect((self.sync, 1), (self.frame, 1))
-        self.connect((self.frame, 0), (self.cvt, 0))
-        self.connect((self.frame, 1), (self.cvt, 1))
+	self.connect((self.detect, 0), (self.frame, 0))
+	self.connect(self.sync, (self.frame, 1))
+        self.connect((self.detect, 0), (self.cvt, 0))
+        self.connect(self.frame, (self.cvt, 1))
         self.connect((self.cvt, 0), (self.scope, 0))
         self.connect((self.cvt, 1), (self.scope,1))
         self.connect((self.cvt, 2), (self.scope,2))